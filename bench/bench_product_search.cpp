@@ -0,0 +1,130 @@
+#include "../src/database/DatabaseManager.h"
+#include "../src/database/DatabaseConnection.h"
+#include "../src/database/TransactionScope.h"
+#include "../src/repositories/ProductRepository.h"
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QLoggingCategory>
+#include <QSqlQuery>
+#include <QSqlError>
+
+namespace {
+// Objetivo de la búsqueda FTS5: menos de 5 ms con 200k productos
+constexpr int kCatalogSize = 200000;
+constexpr int kResultLimit = 50;
+
+// Nombres repartidos en 7 palabras y 500 marcas; 1 de cada 10 inactivo
+const char* const kCatalogSql =
+    "WITH RECURSIVE n(i) AS (SELECT 1 UNION ALL SELECT i + 1 FROM n WHERE i < ?) "
+    "INSERT INTO products (name, sku, barcode, current_stock, minimum_stock, "
+    "purchase_price, sale_price, description, active) "
+    "SELECT CASE i % 7 WHEN 0 THEN 'Leche' WHEN 1 THEN 'Arroz' WHEN 2 THEN 'Azúcar' "
+    "                  WHEN 3 THEN 'Aceite' WHEN 4 THEN 'Galletas' WHEN 5 THEN 'Jabón' "
+    "                  ELSE 'Café' END "
+    "       || ' Marca' || (i % 500) || ' ' || (i % 37 + 1) || '00g', "
+    "       'SKU-' || i, '775' || printf('%010d', i), 25, 5, 6.5, 10, "
+    "       'Producto de prueba ' || (i % 1000), i % 10 <> 0 "
+    "FROM n";
+}
+
+/**
+ * @brief Latencia de ProductRepository::search con 200k productos
+ *
+ * Filas de datos de más selectiva a menos:
+ * - sku / barcode: un solo producto
+ * - twoWords: "leche marca12" (unas 570 coincidencias activas)
+ * - commonPrefix: "le", un prefijo de 1 de cada 7 nombres (~26k activas)
+ *
+ * bestMatchFirst verifica el orden: el producto más relevante se crea al
+ * final del catálogo y aun así debe ser el primer resultado, por delante de
+ * uno más relevante pero inactivo.
+ */
+class ProductSearchBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void bestMatchFirst();
+    void search_data();
+    void search();
+    void searchSummaries_data();
+    void searchSummaries();
+
+private:
+    QTemporaryDir m_dir;
+};
+
+void ProductSearchBenchmark::initTestCase()
+{
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QVERIFY(m_dir.isValid());
+    QVERIFY(DatabaseManager::instance().initialize(m_dir.filePath("bench.db")));
+
+    // Los triggers de la migración 4 llenan products_fts
+    DatabaseConnection conn;
+    TransactionScope transaction;
+    QVERIFY(transaction.isActive());
+
+    QSqlQuery query(conn.database());
+    QVERIFY(query.prepare(kCatalogSql));
+    query.addBindValue(kCatalogSize);
+    QVERIFY2(conn.exec(query, Q_FUNC_INFO), qPrintable(query.lastError().text()));
+
+    QVERIFY2(conn.exec(query,
+                       "INSERT INTO products (name, sku, description, active) VALUES "
+                       "('Leche Leche Entera', 'LECHE-INACTIVA', 'Leche', 0), "
+                       "('Leche Entera', 'LECHE-1', 'Leche', 1)",
+                       Q_FUNC_INFO),
+             qPrintable(query.lastError().text()));
+    QVERIFY(transaction.commit());
+}
+
+void ProductSearchBenchmark::bestMatchFirst()
+{
+    const QList<Product> results = ProductRepository().search("leche", kResultLimit);
+    QCOMPARE(results.size(), kResultLimit);
+    QCOMPARE(results.first().sku, QString("LECHE-1"));
+    for (const Product& product : results) {
+        QVERIFY(product.active);
+    }
+}
+
+void ProductSearchBenchmark::search_data()
+{
+    QTest::addColumn<QString>("text");
+
+    QTest::newRow("sku") << "SKU-123456";
+    QTest::newRow("barcode") << "7750000123456";
+    QTest::newRow("twoWords") << "leche marca12";
+    QTest::newRow("commonPrefix") << "le";
+}
+
+void ProductSearchBenchmark::search()
+{
+    QFETCH(QString, text);
+
+    ProductRepository repository;
+    QBENCHMARK {
+        QVERIFY(!repository.search(text, kResultLimit).isEmpty());
+    }
+}
+
+void ProductSearchBenchmark::searchSummaries_data()
+{
+    search_data();
+}
+
+void ProductSearchBenchmark::searchSummaries()
+{
+    QFETCH(QString, text);
+
+    ProductRepository repository;
+    QBENCHMARK {
+        QVERIFY(!repository.searchSummaries(text, kResultLimit).isEmpty());
+    }
+}
+
+QTEST_GUILESS_MAIN(ProductSearchBenchmark)
+#include "bench_product_search.moc"
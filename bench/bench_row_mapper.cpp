@@ -0,0 +1,183 @@
+#include "../src/database/RowMapper.h"
+#include "../src/models/Product.h"
+#include <QtTest>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+
+namespace {
+constexpr int kRows = 100000;
+
+const char* const kScanSql =
+    "SELECT id, name, sku, barcode, category_id, current_stock, minimum_stock, "
+    "purchase_price, sale_price, description, image_path, active, created_at, updated_at "
+    "FROM products ORDER BY id";
+
+enum Column {
+    ColId, ColName, ColSku, ColBarcode, ColCategoryId, ColCurrentStock, ColMinimumStock,
+    ColPurchasePrice, ColSalePrice, ColDescription, ColImagePath, ColActive,
+    ColCreatedAt, ColUpdatedAt
+};
+}
+
+/**
+ * @brief Mapeo de 100k filas de products: por nombre contra RowMapper
+ *
+ * - byName: query.value("columna") y QDateTime::fromString en cada fila
+ *   (como mapFromQuery antes de RowMapper)
+ * - rowMapper: índices resueltos una vez y fechas sin convertir
+ * - rowMapperReadingDates: igual, pero usando las dos fechas de cada fila
+ *   (costo del camino rápido de LazyDateTime)
+ *
+ * Cada iteración recorre todo el resultado. La base está en memoria para
+ * medir el mapeo y no la E/S.
+ */
+class RowMapperBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void byName();
+    void rowMapper();
+    void rowMapperReadingDates();
+    void cleanupTestCase();
+
+private:
+    QSqlDatabase m_db;
+};
+
+void RowMapperBenchmark::initTestCase()
+{
+    m_db = QSqlDatabase::addDatabase("QSQLITE", "bench_row_mapper");
+    m_db.setDatabaseName(":memory:");
+    QVERIFY(m_db.open());
+
+    QSqlQuery query(m_db);
+    QVERIFY2(query.exec(
+        "CREATE TABLE products ("
+        "id INTEGER PRIMARY KEY, name TEXT, sku TEXT, barcode TEXT, category_id INTEGER, "
+        "current_stock REAL, minimum_stock REAL, purchase_price REAL, sale_price REAL, "
+        "description TEXT, image_path TEXT, active INTEGER, created_at TEXT, updated_at TEXT)"),
+        qPrintable(query.lastError().text()));
+
+    QVERIFY(m_db.transaction());
+    QVERIFY(query.prepare(
+        "INSERT INTO products (name, sku, barcode, category_id, current_stock, minimum_stock, "
+        "purchase_price, sale_price, description, image_path, active, created_at, updated_at) "
+        "VALUES (?, ?, ?, 1, 25, 5, 6.5, 10, '', '', 1, "
+        "datetime('now', ? || ' minutes'), datetime('now'))"));
+    for (int i = 0; i < kRows; ++i) {
+        query.bindValue(0, QString("Producto %1").arg(i));
+        query.bindValue(1, QString("SKU-%1").arg(i));
+        query.bindValue(2, QString("775%1").arg(i, 10, 10, QChar('0')));
+        query.bindValue(3, -i);
+        QVERIFY2(query.exec(), qPrintable(query.lastError().text()));
+    }
+    QVERIFY(m_db.commit());
+}
+
+void RowMapperBenchmark::byName()
+{
+    QBENCHMARK {
+        QSqlQuery query(m_db);
+        query.setForwardOnly(true);
+        QVERIFY(query.exec(kScanSql));
+
+        int rows = 0;
+        while (query.next()) {
+            Product product;
+            product.id = query.value("id").toInt();
+            product.name = query.value("name").toString();
+            product.sku = query.value("sku").toString();
+            product.barcode = query.value("barcode").toString();
+            product.categoryId = query.value("category_id").toInt();
+            product.currentStock = query.value("current_stock").toDouble();
+            product.minimumStock = query.value("minimum_stock").toDouble();
+            product.purchasePrice = query.value("purchase_price").toDouble();
+            product.salePrice = query.value("sale_price").toDouble();
+            product.description = query.value("description").toString();
+            product.imagePath = query.value("image_path").toString();
+            product.active = query.value("active").toBool();
+            product.createdAt = QDateTime::fromString(query.value("created_at").toString(), Qt::ISODate);
+            product.updatedAt = QDateTime::fromString(query.value("updated_at").toString(), Qt::ISODate);
+            ++rows;
+        }
+        QCOMPARE(rows, kRows);
+    }
+}
+
+static Product mapWithRowMapper(const RowMapper& row)
+{
+    Product product;
+    product.id = row.toInt(ColId);
+    product.name = row.toString(ColName);
+    product.sku = row.toString(ColSku);
+    product.barcode = row.toString(ColBarcode);
+    product.categoryId = row.toInt(ColCategoryId);
+    product.currentStock = row.toDouble(ColCurrentStock);
+    product.minimumStock = row.toDouble(ColMinimumStock);
+    product.purchasePrice = row.toDouble(ColPurchasePrice);
+    product.salePrice = row.toDouble(ColSalePrice);
+    product.description = row.toString(ColDescription);
+    product.imagePath = row.toString(ColImagePath);
+    product.active = row.toBool(ColActive);
+    product.createdAt = row.toDateTime(ColCreatedAt);
+    product.updatedAt = row.toDateTime(ColUpdatedAt);
+    return product;
+}
+
+static RowMapper productRow(const QSqlQuery& query)
+{
+    return RowMapper(query, {
+        "id", "name", "sku", "barcode", "category_id", "current_stock", "minimum_stock",
+        "purchase_price", "sale_price", "description", "image_path", "active",
+        "created_at", "updated_at"
+    });
+}
+
+void RowMapperBenchmark::rowMapper()
+{
+    QBENCHMARK {
+        QSqlQuery query(m_db);
+        query.setForwardOnly(true);
+        QVERIFY(query.exec(kScanSql));
+
+        const RowMapper row = productRow(query);
+        int rows = 0;
+        while (query.next()) {
+            const Product product = mapWithRowMapper(row);
+            Q_UNUSED(product);
+            ++rows;
+        }
+        QCOMPARE(rows, kRows);
+    }
+}
+
+void RowMapperBenchmark::rowMapperReadingDates()
+{
+    QBENCHMARK {
+        QSqlQuery query(m_db);
+        query.setForwardOnly(true);
+        QVERIFY(query.exec(kScanSql));
+
+        const RowMapper row = productRow(query);
+        qint64 checksum = 0;
+        while (query.next()) {
+            const Product product = mapWithRowMapper(row);
+            checksum += product.createdAt.toDateTime().toSecsSinceEpoch()
+                      - product.updatedAt.toDateTime().toSecsSinceEpoch();
+        }
+        QVERIFY(checksum <= 0);
+    }
+}
+
+void RowMapperBenchmark::cleanupTestCase()
+{
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase("bench_row_mapper");
+}
+
+QTEST_GUILESS_MAIN(RowMapperBenchmark)
+#include "bench_row_mapper.moc"
@@ -0,0 +1,127 @@
+#include "../src/database/DatabaseManager.h"
+#include "../src/database/TransactionScope.h"
+#include "../src/services/ProductService.h"
+#include "../src/services/CatalogIndex.h"
+#include "../src/viewmodels/SalesCartViewModel.h"
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QLoggingCategory>
+
+namespace {
+// Catálogo de una tienda mediana; el carrito rota entre kCartProducts códigos
+constexpr int kCatalogSize = 20000;
+constexpr int kCartProducts = 50;
+
+QString barcodeFor(int i)
+{
+    return QString("775%1").arg(i, 10, 10, QChar('0'));
+}
+}
+
+/**
+ * @brief Latencia de escaneo a carrito (SalesCartViewModel::searchAndAddProduct)
+ *
+ * - indexLookup: solo CatalogIndex::findByCode (código de barras y SKU)
+ * - scanToCart: escaneo completo con el índice cargado (el camino de la caja)
+ * - sqlLookup: búsqueda por código de barras en SQLite, el camino sin índice
+ */
+class ScanToCartBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void indexLookup_data();
+    void indexLookup();
+    void scanToCart();
+    void sqlLookup();
+
+private:
+    QTemporaryDir m_dir;
+    QStringList m_codes;  // Códigos escaneados, repartidos en el catálogo
+};
+
+void ScanToCartBenchmark::initTestCase()
+{
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QVERIFY(m_dir.isValid());
+    QVERIFY(DatabaseManager::instance().initialize(m_dir.filePath("bench.db")));
+
+    // Una sola transacción: cada producto en su propio savepoint
+    ProductService productService;
+    TransactionScope transaction;
+    QVERIFY(transaction.isActive());
+    for (int i = 0; i < kCatalogSize; ++i) {
+        Product product;
+        product.name = QString("Producto %1").arg(i);
+        product.sku = QString("SKU-%1").arg(i);
+        product.barcode = barcodeFor(i);
+        product.salePrice = 10.0;
+        product.currentStock = 1e6;
+
+        QString errorMessage;
+        QVERIFY2(productService.createProduct(product, errorMessage), qPrintable(errorMessage));
+    }
+    QVERIFY(transaction.commit());
+
+    QVERIFY(CatalogIndex::instance().load());
+    QCOMPARE(CatalogIndex::instance().size(), kCatalogSize);
+
+    const int step = kCatalogSize / kCartProducts;
+    for (int i = 0; i < kCartProducts; ++i) {
+        m_codes.append(barcodeFor(i * step));
+    }
+}
+
+void ScanToCartBenchmark::indexLookup_data()
+{
+    QTest::addColumn<bool>("bySku");
+
+    QTest::newRow("barcode") << false;
+    QTest::newRow("sku") << true;  // Falla el código de barras y luego acierta el SKU
+}
+
+void ScanToCartBenchmark::indexLookup()
+{
+    QFETCH(bool, bySku);
+
+    QStringList codes = m_codes;
+    if (bySku) {
+        const int step = kCatalogSize / kCartProducts;
+        for (int i = 0; i < codes.size(); ++i) {
+            codes[i] = QString("SKU-%1").arg(i * step);
+        }
+    }
+
+    int next = 0;
+    QBENCHMARK {
+        QVERIFY(CatalogIndex::instance().findByCode(codes[next]).has_value());
+        next = (next + 1) % codes.size();
+    }
+}
+
+void ScanToCartBenchmark::scanToCart()
+{
+    SalesCartViewModel viewModel;
+
+    int next = 0;
+    QBENCHMARK {
+        QVERIFY(viewModel.searchAndAddProduct(m_codes[next]));
+        next = (next + 1) % m_codes.size();
+    }
+}
+
+void ScanToCartBenchmark::sqlLookup()
+{
+    ProductService productService;
+
+    int next = 0;
+    QBENCHMARK {
+        QVERIFY(productService.getProductByBarcode(m_codes[next]).has_value());
+        next = (next + 1) % m_codes.size();
+    }
+}
+
+QTEST_GUILESS_MAIN(ScanToCartBenchmark)
+#include "bench_scan_to_cart.moc"
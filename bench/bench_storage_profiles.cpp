@@ -0,0 +1,88 @@
+#include "../src/database/DatabaseManager.h"
+#include "../src/services/ProductService.h"
+#include "../src/services/SalesService.h"
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QLoggingCategory>
+#include <utility>
+
+/**
+ * @brief Latencia de commit de una venta con cada perfil de almacenamiento
+ *
+ * Cada iteración es una venta de caja completa (SalesService::createSale):
+ * número de comprobante, stock, movimientos, items, resúmenes y commit.
+ * La base está en disco (QTemporaryDir) para que cuenten los fsync de cada
+ * perfil.
+ */
+class StorageProfileBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void saleCommit_data();
+    void saleCommit();
+
+private:
+    QTemporaryDir m_dir;
+    QList<int> m_productIds;
+};
+
+void StorageProfileBenchmark::initTestCase()
+{
+    // createSale registra cada paso con qDebug
+    QLoggingCategory::setFilterRules("*.debug=false");
+
+    QVERIFY(m_dir.isValid());
+    QVERIFY(DatabaseManager::instance().initialize(m_dir.filePath("bench.db")));
+
+    ProductService products;
+    for (int i = 0; i < 3; ++i) {
+        Product product;
+        product.name = QString("Producto %1").arg(i + 1);
+        product.sku = QString("BENCH-%1").arg(i + 1);
+        product.purchasePrice = 6.0 + i;
+        product.salePrice = 10.0 + i;
+        product.currentStock = 1e9;  // No se agota durante la medición
+
+        QString errorMessage;
+        QVERIFY2(products.createProduct(product, errorMessage), qPrintable(errorMessage));
+        m_productIds.append(product.id);
+    }
+}
+
+void StorageProfileBenchmark::saleCommit_data()
+{
+    QTest::addColumn<QString>("profile");
+
+    for (const QString& name : DatabaseManager::storageProfileNames()) {
+        QTest::newRow(qPrintable(name)) << name;
+    }
+}
+
+void StorageProfileBenchmark::saleCommit()
+{
+    QFETCH(QString, profile);
+    QVERIFY(DatabaseManager::instance().setStorageProfile(profile));
+
+    SalesService sales;
+    QBENCHMARK {
+        Sale sale;
+        for (int productId : std::as_const(m_productIds)) {
+            SaleItem item;
+            item.productId = productId;
+            item.productName = "Producto";
+            item.quantity = 1;
+            item.unitPrice = 10.0;
+            item.calculateSubtotal();
+            sale.items.append(item);
+        }
+        sale.calculateTotals();
+
+        QString errorMessage;
+        QVERIFY2(sales.createSale(sale, errorMessage), qPrintable(errorMessage));
+    }
+}
+
+QTEST_GUILESS_MAIN(StorageProfileBenchmark)
+#include "bench_storage_profiles.moc"
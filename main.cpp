@@ -1,7 +1,10 @@
 #include <QApplication>
 #include <QQmlApplicationEngine>
 #include <QQuickStyle>
+#include <QFileInfo>
 #include "src/database/DatabaseManager.h"
+#include "src/database/QueryProfiler.h"
+#include "src/services/CatalogIndex.h"
 #include "src/viewmodels/DashboardViewModel.h"
 #include "src/viewmodels/ProductListModel.h"
 #include "src/viewmodels/SalesCartViewModel.h"
@@ -9,6 +12,7 @@
 #include "src/viewmodels/ExcelImportViewModel.h"
 #include "src/viewmodels/ReportsViewModel.h"
 #include "src/utils/BarcodeScannerHandler.h"
+#include "src/utils/UiStallMonitor.h"
 
 int main(int argc, char *argv[])
 {
@@ -33,8 +37,14 @@ int main(int argc, char *argv[])
         qCritical() << "La aplicación continuará con funcionalidad limitada";
     } else {
         qDebug() << "✓ Base de datos inicializada correctamente";
+
+        // Índice de códigos para el punto de venta, en segundo plano
+        CatalogIndex::instance().loadAsync();
     }
 
+    // Medir bloqueos del hilo de UI (cuadros que QML no pudo dibujar)
+    UiStallMonitor::instance().start();
+
     // Registrar tipos QML manualmente
     qmlRegisterType<DashboardViewModel>("SistemaInventario", 1, 0, "DashboardViewModel");
     qmlRegisterType<ProductListModel>("SistemaInventario", 1, 0, "ProductListModel");
@@ -70,5 +80,13 @@ int main(int argc, char *argv[])
 
     qDebug() << "=== Sistema iniciado correctamente ===";
 
-    return app.exec();
+    const int exitCode = app.exec();
+
+    // Histogramas de latencia por sentencia para diagnóstico
+    if (db.isConnected()) {
+        const QString logDir = QFileInfo(QueryProfiler::instance().slowLogPath()).absolutePath();
+        QueryProfiler::instance().dumpJson(logDir + "/query_stats.json");
+    }
+
+    return exitCode;
 }
@@ -0,0 +1,136 @@
+#include "DatabaseConnection.h"
+#include "QueryProfiler.h"
+#include <QElapsedTimer>
+#include <utility>
+
+CachedQuery::CachedQuery(QSqlQuery* query, bool* inUse, const QSqlDatabase* db)
+    : m_query(query)
+    , m_inUse(inUse)
+    , m_db(db)
+{
+}
+
+CachedQuery::CachedQuery(CachedQuery&& other) noexcept
+    : m_query(std::exchange(other.m_query, nullptr))
+    , m_inUse(std::exchange(other.m_inUse, nullptr))
+    , m_db(other.m_db)
+    , m_pendingSelect(std::exchange(other.m_pendingSelect, std::nullopt))
+    , m_lastRow(other.m_lastRow)
+{
+}
+
+CachedQuery::~CachedQuery()
+{
+    if (!m_query) {
+        return;  // Movido
+    }
+
+    recordPendingSelect();
+
+    if (m_inUse) {
+        // Liberar el cursor y devolver la sentencia a la caché
+        m_query->finish();
+        *m_inUse = false;
+    } else {
+        delete m_query;
+    }
+}
+
+int CachedQuery::rowsRead() const
+{
+    const int row = m_query->at();
+    if (row >= 0) {
+        return row + 1;
+    }
+    if (row == QSql::AfterLastRow) {
+        // Cursor agotado: m_lastRow es la última fila antes del next() final
+        return m_lastRow + 1;
+    }
+    return 0;
+}
+
+void CachedQuery::recordPendingSelect()
+{
+    if (!m_pendingSelect) {
+        return;
+    }
+
+    const PendingSelect pending = *m_pendingSelect;
+    m_pendingSelect.reset();
+    QueryProfiler::instance().record(*m_db, *m_query, pending.caller, pending.elapsedNs,
+                                     true, rowsRead());
+}
+
+DatabaseConnection::DatabaseConnection()
+    : m_connection(DatabaseManager::instance().activeConnection())
+{
+}
+
+QSqlDatabase& DatabaseConnection::database()
+{
+    return m_connection->db;
+}
+
+CachedQuery DatabaseConnection::prepare(const QString& sql)
+{
+    bool* inUse = nullptr;
+    QSqlQuery* query = DatabaseManager::instance().acquireStatement(m_connection, sql, inUse);
+    return CachedQuery(query, inUse, &m_connection->db);
+}
+
+bool DatabaseConnection::exec(QSqlQuery& query, const char* caller)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const bool success = query.exec();
+    const qint64 elapsedNs = timer.nsecsElapsed();
+
+    // SQLite no informa filas de un SELECT hasta recorrerlo (ver exec(CachedQuery&))
+    const int rows = query.isSelect() ? -1 : query.numRowsAffected();
+    QueryProfiler::instance().record(m_connection->db, query, caller, elapsedNs, success, rows);
+    return success;
+}
+
+bool DatabaseConnection::exec(CachedQuery& query, const char* caller)
+{
+    // La ejecución anterior de esta sentencia termina aquí
+    query.recordPendingSelect();
+
+    QElapsedTimer timer;
+    timer.start();
+    const bool success = query.m_query->exec();
+    const qint64 elapsedNs = timer.nsecsElapsed();
+    query.m_lastRow = QSql::BeforeFirstRow;
+
+    if (success && query.m_query->isSelect()) {
+        // Las filas se conocen al liberar el cursor (~CachedQuery)
+        query.m_pendingSelect = CachedQuery::PendingSelect{caller, elapsedNs};
+        return true;
+    }
+
+    const int rows = query.m_query->isSelect() ? -1 : query.m_query->numRowsAffected();
+    QueryProfiler::instance().record(m_connection->db, *query.m_query, caller, elapsedNs, success, rows);
+    return success;
+}
+
+bool DatabaseConnection::exec(QSqlQuery& query, const QString& sql, const char* caller)
+{
+    QElapsedTimer timer;
+    timer.start();
+    const bool success = query.exec(sql);
+    const qint64 elapsedNs = timer.nsecsElapsed();
+
+    const int rows = query.isSelect() ? -1 : query.numRowsAffected();
+    QueryProfiler::instance().record(m_connection->db, query, caller, elapsedNs, success, rows);
+    return success;
+}
+
+bool DatabaseConnection::isOpen() const
+{
+    return m_connection->db.isOpen();
+}
+
+QString DatabaseConnection::connectionName() const
+{
+    return m_connection->db.connectionName();
+}
@@ -0,0 +1,150 @@
+#ifndef DATABASECONNECTION_H
+#define DATABASECONNECTION_H
+
+#include "DatabaseManager.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <optional>
+
+/**
+ * @brief Sentencia preparada obtenida de la caché de la conexión
+ *
+ * Se usa como un puntero a QSqlQuery. Al destruirse libera el cursor
+ * (finish()) y devuelve la sentencia a la caché, de modo que no queda
+ * una transacción de lectura abierta entre llamadas.
+ *
+ * Un SELECT ejecutado con DatabaseConnection::exec(CachedQuery&) se
+ * registra en QueryProfiler al liberar el cursor (o al volver a
+ * ejecutarlo), con las filas que se leyeron.
+ */
+class CachedQuery
+{
+public:
+    CachedQuery(QSqlQuery* query, bool* inUse, const QSqlDatabase* db);
+    CachedQuery(CachedQuery&& other) noexcept;
+    ~CachedQuery();
+
+    CachedQuery(const CachedQuery&) = delete;
+    CachedQuery& operator=(const CachedQuery&) = delete;
+    CachedQuery& operator=(CachedQuery&&) = delete;
+
+    QSqlQuery* operator->() const
+    {
+        // Posición antes de cada llamada (next() incluido): al agotarse el
+        // cursor at() ya no dice cuántas filas se leyeron
+        const int row = m_query->at();
+        if (row != QSql::AfterLastRow) {
+            m_lastRow = row;
+        }
+        return m_query;
+    }
+    QSqlQuery& operator*() const { return *m_query; }
+
+    /**
+     * @brief Filas leídas desde la última ejecución
+     */
+    int rowsRead() const;
+
+private:
+    friend class DatabaseConnection;
+
+    // SELECT ejecutado, pendiente de registrar con sus filas
+    struct PendingSelect {
+        const char* caller;
+        qint64 elapsedNs;
+    };
+
+    /**
+     * @brief Registrar el SELECT pendiente, si lo hay
+     */
+    void recordPendingSelect();
+
+    QSqlQuery* m_query;
+    bool* m_inUse;  // nullptr: sentencia temporal, propiedad de este objeto
+    const QSqlDatabase* m_db;
+    std::optional<PendingSelect> m_pendingSelect;
+    mutable int m_lastRow = QSql::BeforeFirstRow;
+};
+
+/**
+ * @brief Manejador con alcance de la conexión del hilo actual
+ *
+ * Los repositorios y servicios crean un DatabaseConnection local y
+ * construyen sus QSqlQuery sobre él, en lugar de usar directamente
+ * DatabaseManager::database(). El manejador obtiene del pool la conexión
+ * del hilo que lo crea, por lo que NO debe compartirse entre hilos. Si el
+ * hilo tiene una ReadSnapshot abierta, obtiene la conexión de solo lectura.
+ *
+ * Uso:
+ * @code
+ * DatabaseConnection conn;
+ * QSqlQuery query(conn.database());
+ *
+ * // Rutas calientes: sentencia preparada reutilizada de la caché
+ * auto cached = conn.prepare("SELECT ... WHERE id = :id");
+ * cached->bindValue(":id", id);
+ * conn.exec(cached, Q_FUNC_INFO);
+ * @endcode
+ *
+ * Todas las ejecuciones pasan por exec(), que mide la consulta y la
+ * registra en QueryProfiler (histogramas y log de consultas lentas).
+ */
+class DatabaseConnection
+{
+public:
+    DatabaseConnection();
+
+    // No copiable: representa la conexión del hilo que lo creó
+    DatabaseConnection(const DatabaseConnection&) = delete;
+    DatabaseConnection& operator=(const DatabaseConnection&) = delete;
+
+    /**
+     * @brief Conexión QSQLITE del hilo actual
+     */
+    QSqlDatabase& database();
+
+    /**
+     * @brief Obtener una sentencia ya preparada para el SQL indicado
+     *
+     * La caché vive en la conexión (clave: texto SQL), así que el SQL se
+     * analiza una sola vez por hilo. Los valores enlazados de la ejecución
+     * anterior permanecen: se deben volver a enlazar todos los parámetros.
+     */
+    CachedQuery prepare(const QString& sql);
+
+    /**
+     * @brief Ejecutar una consulta preparada midiendo su duración
+     * @param caller Función que ejecuta la consulta (usar Q_FUNC_INFO)
+     * @return Resultado de QSqlQuery::exec()
+     */
+    bool exec(QSqlQuery& query, const char* caller);
+
+    /**
+     * @brief Ejecutar una sentencia de la caché midiendo su duración
+     *
+     * Igual que exec(QSqlQuery&), pero un SELECT se registra al liberar el
+     * cursor, con las filas leídas en lugar de -1.
+     */
+    bool exec(CachedQuery& query, const char* caller);
+
+    /**
+     * @brief Ejecutar SQL directo midiendo su duración
+     */
+    bool exec(QSqlQuery& query, const QString& sql, const char* caller);
+
+    /**
+     * @brief Verificar si la conexión está abierta
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Nombre de la conexión dentro del pool
+     */
+    QString connectionName() const;
+
+private:
+    DatabaseManager::ThreadConnection* m_connection;
+};
+
+#endif // DATABASECONNECTION_H
@@ -1,9 +1,16 @@
 #include "DatabaseManager.h"
+#include "QueryProfiler.h"
+#include "MaintenanceScheduler.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDir>
 #include <QStandardPaths>
+#include <QThread>
+#include <QDateTime>
+#include <QStringList>
 #include <QDebug>
+#include <algorithm>
+#include <utility>
 
 DatabaseManager::DatabaseManager(QObject *parent)
     : QObject(parent)
@@ -13,9 +20,30 @@ DatabaseManager::DatabaseManager(QObject *parent)
 
 DatabaseManager::~DatabaseManager()
 {
-    if (m_database.isOpen()) {
-        m_database.close();
+    // Las conexiones de cada hilo las libera QThreadStorage al terminar el hilo
+}
+
+// Límite de sentencias por conexión; los repositorios usan unas pocas decenas
+static const int kMaxCachedStatements = 64;
+
+DatabaseManager::ThreadConnection::~ThreadConnection()
+{
+    if (statementStats.hits + statementStats.misses > 0) {
+        qDebug() << "Conexión" << name << "- caché de sentencias:"
+                 << statementStats.hits << "aciertos," << statementStats.misses << "fallos";
+    }
+
+    // Las sentencias deben liberarse antes de cerrar la conexión
+    qDeleteAll(statements);
+    statements.clear();
+
+    if (db.isOpen()) {
+        db.close();
+        DatabaseManager::instance().m_openConnections.fetchAndSubOrdered(1);
     }
+    // Soltar el handle antes de eliminar la conexión con nombre
+    db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(name);
 }
 
 DatabaseManager& DatabaseManager::instance()
@@ -45,21 +73,17 @@ bool DatabaseManager::initialize(const QString& dbPath)
 
     qDebug() << "Inicializando base de datos en:" << databasePath;
 
-    // Crear conexión SQLite
-    m_database = QSqlDatabase::addDatabase("QSQLITE");
-    m_database.setDatabaseName(databasePath);
+    // Abrir la conexión del hilo principal (el resto se abre bajo demanda)
+    m_databasePath = databasePath;
+    ThreadConnection* connection = threadConnection();
 
-    if (!m_database.open()) {
-        m_lastError = m_database.lastError().text();
+    if (!connection->db.isOpen()) {
+        m_lastError = connection->db.lastError().text();
         qCritical() << "Error abriendo base de datos:" << m_lastError;
         emit databaseError(m_lastError);
         return false;
     }
 
-    // Habilitar foreign keys en SQLite
-    QSqlQuery query(m_database);
-    query.exec("PRAGMA foreign_keys = ON");
-
     // Ejecutar migraciones
     if (!runMigrations()) {
         m_lastError = "Error ejecutando migraciones";
@@ -68,6 +92,17 @@ bool DatabaseManager::initialize(const QString& dbPath)
         return false;
     }
 
+    // Pragmas de almacenamiento según el perfil guardado
+    loadStorageProfile();
+
+    // Umbral y ubicación del log de consultas lentas
+    QueryProfiler::instance().loadSettings(database());
+
+    // Mantenimiento en períodos sin ventas
+    m_lastWriteMs.storeRelease(QDateTime::currentMSecsSinceEpoch());
+    m_maintenance = std::make_unique<MaintenanceScheduler>();
+    m_maintenance->start();
+
     m_initialized = true;
     emit databaseReady();
     qDebug() << "Base de datos inicializada correctamente";
@@ -77,30 +112,480 @@ bool DatabaseManager::initialize(const QString& dbPath)
 
 QSqlDatabase& DatabaseManager::database()
 {
-    return m_database;
+    return threadConnection()->db;
+}
+
+QString DatabaseManager::databasePath() const
+{
+    return m_databasePath;
+}
+
+int DatabaseManager::openConnectionCount() const
+{
+    return m_openConnections.loadAcquire();
+}
+
+DatabaseManager::ThreadConnection* DatabaseManager::threadConnection()
+{
+    if (m_connections.hasLocalData()) {
+        ThreadConnection* connection = m_connections.localData();
+        if (connection->db.isOpen()) {
+            // El perfil cambió desde otro hilo: aplicarlo fuera de transacción
+            if (connection->profileGeneration != m_profileGeneration.loadAcquire()
+                && connection->transactionDepth == 0) {
+                applyStorageProfile(connection);
+            }
+            return connection;
+        }
+        // Reintentar si el hilo pidió su conexión antes de initialize()
+        if (m_databasePath.isEmpty()) {
+            return connection;
+        }
+    } else {
+        ThreadConnection* connection = new ThreadConnection;
+        connection->name = QString("inventory_conn_%1").arg(m_connectionSerial.fetchAndAddOrdered(1));
+        m_connections.setLocalData(connection);
+    }
+
+    ThreadConnection* connection = m_connections.localData();
+    if (m_databasePath.isEmpty()) {
+        return connection;  // Aún no inicializada: conexión inválida
+    }
+
+    if (!connection->db.isValid()) {
+        connection->db = QSqlDatabase::addDatabase("QSQLITE", connection->name);
+        connection->db.setDatabaseName(m_databasePath);
+        // Varias conexiones escriben el mismo archivo: esperar el lock en vez de fallar
+        connection->db.setConnectOptions("QSQLITE_BUSY_TIMEOUT=5000");
+    }
+
+    if (!connection->db.open()) {
+        qCritical() << "Error abriendo conexión" << connection->name << ":"
+                    << connection->db.lastError().text();
+        return connection;
+    }
+
+    m_openConnections.fetchAndAddOrdered(1);
+    configureConnection(connection->db);
+    applyStorageProfile(connection);
+    qDebug() << "Conexión" << connection->name << "abierta en hilo" << QThread::currentThread();
+
+    return connection;
+}
+
+DatabaseManager::ThreadConnection* DatabaseManager::snapshotConnection()
+{
+    if (!m_snapshotConnections.hasLocalData()) {
+        ThreadConnection* connection = new ThreadConnection;
+        connection->name = QString("inventory_snapshot_%1").arg(m_connectionSerial.fetchAndAddOrdered(1));
+        m_snapshotConnections.setLocalData(connection);
+    }
+
+    ThreadConnection* connection = m_snapshotConnections.localData();
+    if (connection->db.isOpen() || m_databasePath.isEmpty()) {
+        return connection;
+    }
+
+    if (!connection->db.isValid()) {
+        connection->db = QSqlDatabase::addDatabase("QSQLITE", connection->name);
+        connection->db.setDatabaseName(m_databasePath);
+        connection->db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000");
+    }
+
+    if (!connection->db.open()) {
+        qCritical() << "Error abriendo conexión" << connection->name << ":"
+                    << connection->db.lastError().text();
+        return connection;
+    }
+
+    m_openConnections.fetchAndAddOrdered(1);
+
+    // Solo los pragmas de caché: journal_mode y synchronous no aplican a lectura
+    QSqlQuery query(connection->db);
+    {
+        QMutexLocker locker(&m_profileMutex);
+        query.exec(QString("PRAGMA cache_size = -%1").arg(m_storageProfile.cacheSizeKb));
+        query.exec(QString("PRAGMA mmap_size = %1").arg(m_storageProfile.mmapSize));
+    }
+    qDebug() << "Conexión" << connection->name << "(solo lectura) abierta en hilo" << QThread::currentThread();
+
+    return connection;
+}
+
+DatabaseManager::ThreadConnection* DatabaseManager::activeConnection()
+{
+    // Una transacción de escritura abierta tiene prioridad: la instantánea es
+    // de solo lectura y no vería los cambios aún sin confirmar
+    if (m_connections.hasLocalData() && m_connections.localData()->transactionDepth > 0) {
+        return m_connections.localData();
+    }
+
+    if (m_snapshotConnections.hasLocalData()) {
+        ThreadConnection* snapshot = m_snapshotConnections.localData();
+        if (snapshot->snapshotDepth > 0) {
+            return snapshot;
+        }
+    }
+    return threadConnection();
+}
+
+bool DatabaseManager::beginReadSnapshot()
+{
+    ThreadConnection* connection = snapshotConnection();
+    if (!connection->db.isOpen()) {
+        return false;
+    }
+
+    if (connection->snapshotDepth == 0) {
+        if (!connection->db.transaction()) {
+            qWarning() << "Error iniciando instantánea de lectura:" << connection->db.lastError().text();
+            return false;
+        }
+
+        // BEGIN es diferido: la primera lectura fija la instantánea WAL
+        QSqlQuery query(connection->db);
+        if (!query.exec("SELECT 1 FROM sqlite_master LIMIT 1")) {
+            qWarning() << "Error iniciando instantánea de lectura:" << query.lastError().text();
+            connection->db.rollback();
+            return false;
+        }
+    }
+
+    connection->snapshotDepth++;
+    return true;
+}
+
+void DatabaseManager::endReadSnapshot()
+{
+    if (!m_snapshotConnections.hasLocalData()
+        || m_snapshotConnections.localData()->snapshotDepth == 0) {
+        qWarning() << "endReadSnapshot() sin instantánea abierta";
+        return;
+    }
+
+    ThreadConnection* connection = m_snapshotConnections.localData();
+    if (--connection->snapshotDepth == 0) {
+        // Soltar la transacción de lectura para no frenar los checkpoints del WAL
+        connection->db.commit();
+    }
+}
+
+DatabaseManager::StatementCacheStats DatabaseManager::statementCacheStats() const
+{
+    StatementCacheStats stats;
+    stats.hits = m_statementHits.loadAcquire();
+    stats.misses = m_statementMisses.loadAcquire();
+    return stats;
+}
+
+QSqlQuery* DatabaseManager::acquireStatement(ThreadConnection* connection, const QString& sql, bool*& inUse)
+{
+    inUse = nullptr;
+
+    CachedStatement* statement = connection->statements.value(sql, nullptr);
+    if (statement) {
+        if (statement->inUse) {
+            // Consulta anidada con el mismo SQL: usar una sentencia temporal,
+            // de solo avance como las de la caché
+            QSqlQuery* query = new QSqlQuery(connection->db);
+            query->setForwardOnly(true);
+            query->prepare(sql);
+            return query;
+        }
+
+        connection->statementStats.hits++;
+        m_statementHits.fetchAndAddRelaxed(1);
+        statement->inUse = true;
+        inUse = &statement->inUse;
+        return &statement->query;
+    }
+
+    connection->statementStats.misses++;
+    m_statementMisses.fetchAndAddRelaxed(1);
+
+    if (connection->statements.size() >= kMaxCachedStatements) {
+        // Vaciar sólo las sentencias libres; las que están en uso siguen vivas
+        for (auto it = connection->statements.begin(); it != connection->statements.end();) {
+            if (it.value()->inUse) {
+                ++it;
+            } else {
+                delete it.value();
+                it = connection->statements.erase(it);
+            }
+        }
+    }
+
+    statement = new CachedStatement(connection->db);
+    statement->query.setForwardOnly(true);
+
+    if (!statement->query.prepare(sql)) {
+        qCritical() << "Error preparando sentencia:" << statement->query.lastError().text();
+        // No se guarda en caché; el llamador verá el error al ejecutar
+        QSqlQuery* query = new QSqlQuery(std::move(statement->query));
+        delete statement;
+        return query;
+    }
+
+    connection->statements.insert(sql, statement);
+    statement->inUse = true;
+    inUse = &statement->inUse;
+    return &statement->query;
+}
+
+bool DatabaseManager::configureConnection(QSqlDatabase& db)
+{
+    QSqlQuery query(db);
+
+    // Habilitar foreign keys en SQLite (es por conexión, no por archivo)
+    if (!query.exec("PRAGMA foreign_keys = ON")) {
+        qWarning() << "Error configurando conexión:" << query.lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<DatabaseManager::StorageProfile> DatabaseManager::storageProfile(const QString& name)
+{
+    StorageProfile profile;
+    profile.name = name;
+
+    if (name == "pos-safe") {
+        // WAL: los lectores no bloquean al escritor; NORMAL: un fsync por checkpoint
+        return profile;
+    }
+
+    if (name == "bulk-import") {
+        profile.cacheSizeKb = 65536;
+        profile.tempStore = "MEMORY";
+        profile.mmapSize = 256LL * 1024 * 1024;
+        return profile;
+    }
+
+    if (name == "paranoid") {
+        profile.synchronous = "FULL";
+        profile.cellSizeCheck = true;
+        return profile;
+    }
+
+    return std::nullopt;
+}
+
+QStringList DatabaseManager::storageProfileNames()
+{
+    return { "pos-safe", "bulk-import", "paranoid" };
+}
+
+QString DatabaseManager::storageProfileName() const
+{
+    QMutexLocker locker(&m_profileMutex);
+    return m_storageProfile.name;
+}
+
+bool DatabaseManager::setStorageProfile(const QString& name, bool persist)
+{
+    auto profile = storageProfile(name);
+    if (!profile) {
+        qWarning() << "Perfil de almacenamiento desconocido:" << name;
+        return false;
+    }
+
+    {
+        QMutexLocker locker(&m_profileMutex);
+        m_storageProfile = *profile;
+    }
+    m_profileGeneration.fetchAndAddOrdered(1);
+
+    ThreadConnection* connection = threadConnection();  // Aplica el perfil si corresponde
+
+    if (persist && connection->db.isOpen()) {
+        QSqlQuery query(connection->db);
+        query.prepare("INSERT OR REPLACE INTO settings (key, value, updated_at) "
+                      "VALUES ('storage_profile', :value, datetime('now'))");
+        query.bindValue(":value", name);
+        if (!query.exec()) {
+            qWarning() << "Error guardando perfil de almacenamiento:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    qDebug() << "Perfil de almacenamiento activo:" << name;
+    return true;
+}
+
+void DatabaseManager::loadStorageProfile()
+{
+    QString name = "pos-safe";
+
+    QSqlQuery query(database());
+    if (query.exec("SELECT value FROM settings WHERE key = 'storage_profile'") && query.next()) {
+        const QString saved = query.value(0).toString();
+        if (storageProfile(saved)) {
+            name = saved;
+        } else {
+            qWarning() << "Perfil guardado inválido, usando pos-safe:" << saved;
+        }
+    }
+
+    setStorageProfile(name);
+}
+
+bool DatabaseManager::applyStorageProfile(ThreadConnection* connection)
+{
+    StorageProfile profile;
+    int generation = 0;
+    {
+        QMutexLocker locker(&m_profileMutex);
+        profile = m_storageProfile;
+        generation = m_profileGeneration.loadAcquire();
+    }
+
+    if (profile.name.isEmpty()) {
+        connection->profileGeneration = generation;
+        return true;  // Aún no se cargó ningún perfil
+    }
+
+    const QStringList pragmas = {
+        QString("PRAGMA journal_mode = %1").arg(profile.journalMode),
+        QString("PRAGMA synchronous = %1").arg(profile.synchronous),
+        QString("PRAGMA cache_size = -%1").arg(profile.cacheSizeKb),
+        QString("PRAGMA temp_store = %1").arg(profile.tempStore),
+        QString("PRAGMA mmap_size = %1").arg(profile.mmapSize),
+        QString("PRAGMA cell_size_check = %1").arg(profile.cellSizeCheck ? "ON" : "OFF")
+    };
+
+    QSqlQuery query(connection->db);
+    for (const QString& pragma : pragmas) {
+        if (!query.exec(pragma)) {
+            qWarning() << "Error aplicando" << pragma << "en" << connection->name << ":"
+                       << query.lastError().text();
+            return false;
+        }
+    }
+
+    connection->profileGeneration = generation;
+    return true;
 }
 
 bool DatabaseManager::beginTransaction()
 {
-    QMutexLocker locker(&m_mutex);
-    return m_database.transaction();
+    ThreadConnection* connection = threadConnection();
+
+    if (connection->transactionDepth == 0) {
+        if (!connection->db.transaction()) {
+            qWarning() << "Error iniciando transacción:" << connection->db.lastError().text();
+            return false;
+        }
+    } else {
+        // Nivel anidado: savepoint con nombre según la profundidad
+        QSqlQuery query(connection->db);
+        if (!query.exec(QString("SAVEPOINT sp_%1").arg(connection->transactionDepth))) {
+            qWarning() << "Error creando savepoint:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    connection->transactionDepth++;
+    return true;
 }
 
 bool DatabaseManager::commit()
 {
-    QMutexLocker locker(&m_mutex);
-    return m_database.commit();
+    ThreadConnection* connection = threadConnection();
+
+    if (connection->transactionDepth == 0) {
+        qWarning() << "commit() sin transacción activa";
+        return false;
+    }
+
+    if (connection->transactionDepth == 1) {
+        if (!connection->db.commit()) {
+            qWarning() << "Error confirmando transacción:" << connection->db.lastError().text();
+            return false;
+        }
+        m_lastWriteMs.storeRelease(QDateTime::currentMSecsSinceEpoch());
+
+        connection->transactionDepth = 0;
+        const auto actions = std::exchange(connection->afterCommit, {});
+        for (const auto& action : actions) {
+            action.second();
+        }
+        return true;
+    }
+
+    // Los cambios del savepoint pasan a formar parte del nivel superior
+    QSqlQuery query(connection->db);
+    if (!query.exec(QString("RELEASE sp_%1").arg(connection->transactionDepth - 1))) {
+        qWarning() << "Error liberando savepoint:" << query.lastError().text();
+        return false;
+    }
+
+    connection->transactionDepth--;
+    for (auto& action : connection->afterCommit) {
+        action.first = std::min(action.first, connection->transactionDepth);
+    }
+    return true;
 }
 
 bool DatabaseManager::rollback()
 {
-    QMutexLocker locker(&m_mutex);
-    return m_database.rollback();
+    ThreadConnection* connection = threadConnection();
+
+    if (connection->transactionDepth == 0) {
+        qWarning() << "rollback() sin transacción activa";
+        return false;
+    }
+
+    connection->transactionDepth--;
+
+    // Descartar las acciones registradas en el nivel revertido
+    const int depth = connection->transactionDepth;
+    connection->afterCommit.removeIf([depth](const auto& action) {
+        return action.first > depth;
+    });
+
+    if (connection->transactionDepth == 0) {
+        return connection->db.rollback();
+    }
+
+    // ROLLBACK TO deja el savepoint abierto: liberarlo para cerrar el nivel
+    const QString savepoint = QString("sp_%1").arg(connection->transactionDepth);
+    QSqlQuery query(connection->db);
+    if (!query.exec("ROLLBACK TO " + savepoint) || !query.exec("RELEASE " + savepoint)) {
+        qWarning() << "Error revirtiendo savepoint:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+int DatabaseManager::transactionDepth()
+{
+    return threadConnection()->transactionDepth;
+}
+
+void DatabaseManager::runAfterCommit(std::function<void()> action)
+{
+    ThreadConnection* connection = threadConnection();
+    if (connection->transactionDepth == 0) {
+        action();
+        return;
+    }
+    connection->afterCommit.append({connection->transactionDepth, std::move(action)});
+}
+
+qint64 DatabaseManager::lastWriteActivity() const
+{
+    return m_lastWriteMs.loadAcquire();
+}
+
+MaintenanceScheduler* DatabaseManager::maintenance() const
+{
+    return m_maintenance.get();
 }
 
 bool DatabaseManager::isConnected() const
 {
-    return m_database.isOpen();
+    return m_initialized;
 }
 
 QString DatabaseManager::lastError() const
@@ -110,7 +595,7 @@ QString DatabaseManager::lastError() const
 
 int DatabaseManager::getCurrentSchemaVersion()
 {
-    QSqlQuery query(m_database);
+    QSqlQuery query(database());
     query.prepare("SELECT version FROM schema_version ORDER BY version DESC LIMIT 1");
     
     if (query.exec() && query.next()) {
@@ -121,7 +606,7 @@ int DatabaseManager::getCurrentSchemaVersion()
 
 bool DatabaseManager::setSchemaVersion(int version)
 {
-    QSqlQuery query(m_database);
+    QSqlQuery query(database());
     query.prepare("INSERT INTO schema_version (version, applied_at) VALUES (?, datetime('now'))");
     query.addBindValue(version);
     return query.exec();
@@ -129,8 +614,33 @@ bool DatabaseManager::setSchemaVersion(int version)
 
 bool DatabaseManager::runMigrations()
 {
+    QSqlQuery query(database());
+
+    // Base nueva: auto_vacuum incremental antes de crear la primera tabla.
+    // Aquí aún no se aplicó ningún perfil de almacenamiento (loadStorageProfile
+    // corre después), así que un archivo nuevo sigue en modo rollback y sin
+    // cabecera: el PRAGMA basta. Solo si el archivo vacío ya tiene cabecera
+    // (p. ej. lo dejó en WAL otro proceso) el modo queda sin cambiar y hace
+    // falta un VACUUM, inmediato sobre una base vacía. La migración 3 lo
+    // encuentra activo y no reconstruye nada.
+    if (query.exec("SELECT COUNT(*) FROM sqlite_master") && query.next()
+        && query.value(0).toInt() == 0) {
+        query.finish();
+        bool enabled = query.exec("PRAGMA auto_vacuum = INCREMENTAL")
+                       && query.exec("PRAGMA auto_vacuum") && query.next()
+                       && query.value(0).toInt() == 2;
+        query.finish();
+        if (!enabled) {
+            enabled = query.exec("VACUUM");
+        }
+        if (!enabled) {
+            qWarning() << "No se pudo activar auto_vacuum en la base nueva:"
+                       << query.lastError().text();
+        }
+    }
+    query.finish();
+
     // Crear tabla de versiones si no existe
-    QSqlQuery query(m_database);
     if (!query.exec("CREATE TABLE IF NOT EXISTS schema_version ("
                    "version INTEGER PRIMARY KEY,"
                    "applied_at TEXT NOT NULL)")) {
@@ -153,15 +663,96 @@ bool DatabaseManager::runMigrations()
         setSchemaVersion(1);
     }
 
+    // Migración 2: columnas de día indexables para filtros por rango de fechas
+    if (currentVersion < 2) {
+        qDebug() << "Aplicando migración 2: Columnas de día indexadas";
+        if (!addDayColumns()) {
+            return false;
+        }
+        setSchemaVersion(2);
+    }
+
+    // Migración 3: auto_vacuum incremental (lo usa el mantenimiento en tiempos muertos)
+    if (currentVersion < 3) {
+        qDebug() << "Aplicando migración 3: auto_vacuum incremental";
+        if (!enableIncrementalVacuum()) {
+            return false;
+        }
+        setSchemaVersion(3);
+    }
+
+    // Migración 4: índice FTS5 para la búsqueda de productos
+    if (currentVersion < 4) {
+        qDebug() << "Aplicando migración 4: Índice de búsqueda de productos (FTS5)";
+        if (!createProductSearchIndex()) {
+            return false;
+        }
+        setSchemaVersion(4);
+    }
+
+    // Migración 5: índice para el listado paginado de productos
+    if (currentVersion < 5) {
+        qDebug() << "Aplicando migración 5: Índice (active, name, id) de productos";
+        if (!addActiveNameIndex()) {
+            return false;
+        }
+        setSchemaVersion(5);
+    }
+
+    // Migración 6: conjunto de productos con stock bajo mantenido al escribir
+    if (currentVersion < 6) {
+        qDebug() << "Aplicando migración 6: Índice parcial de stock bajo";
+        if (!addLowStockIndex()) {
+            return false;
+        }
+        setSchemaVersion(6);
+    }
+
+    // Migración 7: registro de cambios de productos (sincronización por versión)
+    if (currentVersion < 7) {
+        qDebug() << "Aplicando migración 7: Registro de cambios de productos";
+        if (!createProductChangeLog()) {
+            return false;
+        }
+        setSchemaVersion(7);
+    }
+
+    // Migración 8: numeración de comprobantes por serie
+    if (currentVersion < 8) {
+        qDebug() << "Aplicando migración 8: Secuencias de comprobantes";
+        if (!createInvoiceSequences()) {
+            return false;
+        }
+        setSchemaVersion(8);
+    }
+
+    // Migración 9: totales diarios de ventas mantenidos por triggers
+    if (currentVersion < 9) {
+        qDebug() << "Aplicando migración 9: Resumen diario de ventas";
+        if (!createSalesDailySummary()) {
+            return false;
+        }
+        setSchemaVersion(9);
+    }
+
+    // Migración 10: ventas diarias por producto mantenidas por triggers
+    if (currentVersion < 10) {
+        qDebug() << "Aplicando migración 10: Ventas diarias por producto";
+        if (!createProductDailySales()) {
+            return false;
+        }
+        setSchemaVersion(10);
+    }
+
     // Aquí se pueden agregar más migraciones en el futuro
-    // if (currentVersion < 2) { ... }
+    // if (currentVersion < 11) { ... }
 
     return true;
 }
 
 bool DatabaseManager::createTables()
 {
-    QSqlQuery query(m_database);
+    QSqlQuery query(database());
 
     // Tabla de categorías
     if (!query.exec(
@@ -357,11 +948,480 @@ bool DatabaseManager::createTables()
     return true;
 }
 
+bool DatabaseManager::addDayColumns()
+{
+    // Filtrar por DATE(created_at) impide usar idx_sales_date y obliga a
+    // recorrer toda la tabla. Una columna generada VIRTUAL con el día no
+    // ocupa espacio ni necesita rellenarse: SQLite la calcula para las filas
+    // existentes y la mantiene al insertar, y sí puede indexarse.
+    QSqlDatabase& db = database();
+    QSqlQuery query(db);
+
+    if (!db.transaction()) {
+        m_lastError = db.lastError().text();
+        return false;
+    }
+
+    const QStringList statements = {
+        "ALTER TABLE sales ADD COLUMN sale_day TEXT "
+        "GENERATED ALWAYS AS (DATE(created_at)) VIRTUAL",
+        "ALTER TABLE stock_movements ADD COLUMN movement_day TEXT "
+        "GENERATED ALWAYS AS (DATE(created_at)) VIRTUAL",
+        // (día, fecha) permite además ORDER BY sin ordenar en memoria
+        "CREATE INDEX IF NOT EXISTS idx_sales_day ON sales(sale_day, created_at)",
+        "CREATE INDEX IF NOT EXISTS idx_stock_movements_day ON stock_movements(movement_day, created_at)",
+        "ANALYZE sales",
+        "ANALYZE stock_movements"
+    };
+
+    for (const QString& sql : statements) {
+        if (!query.exec(sql)) {
+            m_lastError = query.lastError().text();
+            qCritical() << "Error en migración 2:" << m_lastError;
+            db.rollback();
+            return false;
+        }
+    }
+
+    return db.commit();
+}
+
+bool DatabaseManager::addLowStockIndex()
+{
+    // current_stock <= minimum_stock compara dos columnas: ningún índice
+    // normal lo resuelve y el dashboard recorría todo el catálogo en cada
+    // refresco. La columna generada VIRTUAL se evalúa al escribir la fila y
+    // el índice parcial solo contiene los productos con stock bajo, así que
+    // listarlos o contarlos cuesta lo que mide ese conjunto.
+    QSqlDatabase& db = database();
+    QSqlQuery query(db);
+
+    if (!db.transaction()) {
+        m_lastError = db.lastError().text();
+        return false;
+    }
+
+    const QStringList statements = {
+        "ALTER TABLE products ADD COLUMN low_stock INTEGER "
+        "GENERATED ALWAYS AS (active = 1 AND current_stock <= minimum_stock) VIRTUAL",
+        // Ordenado por stock: findLowStock() lo recorre sin ordenar en memoria
+        "CREATE INDEX IF NOT EXISTS idx_products_low_stock "
+        "ON products(current_stock) WHERE low_stock = 1"
+    };
+
+    for (const QString& sql : statements) {
+        if (!query.exec(sql)) {
+            m_lastError = query.lastError().text();
+            qCritical() << "Error en migración 6:" << m_lastError;
+            db.rollback();
+            return false;
+        }
+    }
+
+    return db.commit();
+}
+
+bool DatabaseManager::createProductChangeLog()
+{
+    // Cada escritura en products agrega una fila; AUTOINCREMENT garantiza
+    // que version crece siempre y nunca se reutiliza, aunque se borren filas
+    // viejas al compactar (ver MaintenanceScheduler). Los triggers capturan
+    // también los cambios hechos fuera de ProductRepository.
+    QSqlDatabase& db = database();
+    QSqlQuery query(db);
+
+    if (!db.transaction()) {
+        m_lastError = db.lastError().text();
+        return false;
+    }
+
+    const QStringList statements = {
+        "CREATE TABLE IF NOT EXISTS product_changes ("
+        "version INTEGER PRIMARY KEY AUTOINCREMENT,"
+        "product_id INTEGER NOT NULL,"
+        "change_type TEXT NOT NULL,"  // I, U, D
+        "changed_at TEXT DEFAULT (datetime('now')))",
+
+        // Compactar: última versión de cada producto
+        "CREATE INDEX IF NOT EXISTS idx_product_changes_product "
+        "ON product_changes(product_id, version)",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_products_changes_insert AFTER INSERT ON products BEGIN "
+        "INSERT INTO product_changes (product_id, change_type) VALUES (NEW.id, 'I'); "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_products_changes_update AFTER UPDATE ON products BEGIN "
+        "INSERT INTO product_changes (product_id, change_type) VALUES (NEW.id, 'U'); "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_products_changes_delete AFTER DELETE ON products BEGIN "
+        "INSERT INTO product_changes (product_id, change_type) VALUES (OLD.id, 'D'); "
+        "END",
+
+        // El nombre de la categoría forma parte de la vista de cada producto
+        "CREATE TRIGGER IF NOT EXISTS trg_categories_changes_update "
+        "AFTER UPDATE OF name ON categories BEGIN "
+        "INSERT INTO product_changes (product_id, change_type) "
+        "SELECT id, 'U' FROM products WHERE category_id = NEW.id; "
+        "END"
+    };
+
+    for (const QString& sql : statements) {
+        if (!query.exec(sql)) {
+            m_lastError = query.lastError().text();
+            qCritical() << "Error en migración 7:" << m_lastError;
+            db.rollback();
+            return false;
+        }
+    }
+
+    return db.commit();
+}
+
+bool DatabaseManager::createInvoiceSequences()
+{
+    // Un contador por prefijo (serie + día). SaleRepository lo incrementa
+    // dentro de la transacción de la venta: la escritura toma el bloqueo de
+    // la base, así que dos terminales nunca obtienen el mismo número, y un
+    // rollback devuelve el número sin dejar huecos.
+    QSqlDatabase& db = database();
+    QSqlQuery query(db);
+
+    if (!db.transaction()) {
+        m_lastError = db.lastError().text();
+        return false;
+    }
+
+    const QStringList statements = {
+        "CREATE TABLE IF NOT EXISTS invoice_sequences ("
+        "prefix TEXT PRIMARY KEY,"       // yyyyMMdd (boleta) o FyyyyMMdd (factura)
+        "series TEXT NOT NULL,"          // BOLETA, FACTURA
+        "last_number INTEGER NOT NULL)",
+
+        // Continuar la numeración de las ventas existentes (formato yyyyMMdd-NNNN)
+        "INSERT OR IGNORE INTO invoice_sequences (prefix, series, last_number) "
+        "SELECT substr(invoice_number, 1, 8), 'BOLETA', "
+        "       MAX(CAST(substr(invoice_number, 10) AS INTEGER)) "
+        "FROM sales "
+        "WHERE invoice_number GLOB '[0-9][0-9][0-9][0-9][0-9][0-9][0-9][0-9]-[0-9]*' "
+        "GROUP BY substr(invoice_number, 1, 8)"
+    };
+
+    for (const QString& sql : statements) {
+        if (!query.exec(sql)) {
+            m_lastError = query.lastError().text();
+            qCritical() << "Error en migración 8:" << m_lastError;
+            db.rollback();
+            return false;
+        }
+    }
+
+    return db.commit();
+}
+
+bool DatabaseManager::createSalesDailySummary()
+{
+    // Los reportes sumaban todas las ventas del rango en cada consulta. Este
+    // resumen guarda una fila por día y método de pago con los totales de
+    // las ventas COMPLETED; los triggers lo actualizan en la misma
+    // transacción que inserta o cancela la venta (SalesService), así que
+    // un rango de un año lee a lo sumo unos cientos de filas.
+    QSqlDatabase& db = database();
+    QSqlQuery query(db);
+
+    if (!db.transaction()) {
+        m_lastError = db.lastError().text();
+        return false;
+    }
+
+    const QStringList statements = {
+        "CREATE TABLE IF NOT EXISTS sales_daily_summary ("
+        "day TEXT NOT NULL,"
+        "payment_method_id INTEGER NOT NULL,"  // 0: sin método de pago
+        "sale_count INTEGER NOT NULL DEFAULT 0,"
+        "gross REAL NOT NULL DEFAULT 0,"       // Suma de subtotal
+        "discount REAL NOT NULL DEFAULT 0,"
+        "tax REAL NOT NULL DEFAULT 0,"
+        "net REAL NOT NULL DEFAULT 0,"         // Suma de total
+        "PRIMARY KEY (day, payment_method_id)"
+        ") WITHOUT ROWID",
+
+        // Carga inicial con las ventas existentes
+        "INSERT OR REPLACE INTO sales_daily_summary "
+        "(day, payment_method_id, sale_count, gross, discount, tax, net) "
+        "SELECT sale_day, COALESCE(payment_method_id, 0), COUNT(*), "
+        "       SUM(subtotal), SUM(discount), SUM(tax), SUM(total) "
+        "FROM sales WHERE status = 'COMPLETED' "
+        "GROUP BY sale_day, COALESCE(payment_method_id, 0)",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_sales_summary_insert AFTER INSERT ON sales "
+        "WHEN NEW.status = 'COMPLETED' BEGIN "
+        "INSERT INTO sales_daily_summary "
+        "(day, payment_method_id, sale_count, gross, discount, tax, net) "
+        "VALUES (NEW.sale_day, COALESCE(NEW.payment_method_id, 0), 1, "
+        "        NEW.subtotal, NEW.discount, NEW.tax, NEW.total) "
+        "ON CONFLICT(day, payment_method_id) DO UPDATE SET "
+        "sale_count = sale_count + 1, gross = gross + excluded.gross, "
+        "discount = discount + excluded.discount, tax = tax + excluded.tax, "
+        "net = net + excluded.net; "
+        "END",
+
+        // Cancelación (o cualquier salida de COMPLETED)
+        "CREATE TRIGGER IF NOT EXISTS trg_sales_summary_cancel AFTER UPDATE OF status ON sales "
+        "WHEN OLD.status = 'COMPLETED' AND NEW.status <> 'COMPLETED' BEGIN "
+        "UPDATE sales_daily_summary SET "
+        "sale_count = sale_count - 1, gross = gross - OLD.subtotal, "
+        "discount = discount - OLD.discount, tax = tax - OLD.tax, net = net - OLD.total "
+        "WHERE day = OLD.sale_day AND payment_method_id = COALESCE(OLD.payment_method_id, 0); "
+        "END",
+
+        // Venta pendiente que pasa a COMPLETED
+        "CREATE TRIGGER IF NOT EXISTS trg_sales_summary_complete AFTER UPDATE OF status ON sales "
+        "WHEN OLD.status <> 'COMPLETED' AND NEW.status = 'COMPLETED' BEGIN "
+        "INSERT INTO sales_daily_summary "
+        "(day, payment_method_id, sale_count, gross, discount, tax, net) "
+        "VALUES (NEW.sale_day, COALESCE(NEW.payment_method_id, 0), 1, "
+        "        NEW.subtotal, NEW.discount, NEW.tax, NEW.total) "
+        "ON CONFLICT(day, payment_method_id) DO UPDATE SET "
+        "sale_count = sale_count + 1, gross = gross + excluded.gross, "
+        "discount = discount + excluded.discount, tax = tax + excluded.tax, "
+        "net = net + excluded.net; "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_sales_summary_delete AFTER DELETE ON sales "
+        "WHEN OLD.status = 'COMPLETED' BEGIN "
+        "UPDATE sales_daily_summary SET "
+        "sale_count = sale_count - 1, gross = gross - OLD.subtotal, "
+        "discount = discount - OLD.discount, tax = tax - OLD.tax, net = net - OLD.total "
+        "WHERE day = OLD.sale_day AND payment_method_id = COALESCE(OLD.payment_method_id, 0); "
+        "END"
+    };
+
+    for (const QString& sql : statements) {
+        if (!query.exec(sql)) {
+            m_lastError = query.lastError().text();
+            qCritical() << "Error en migración 9:" << m_lastError;
+            db.rollback();
+            return false;
+        }
+    }
+
+    return db.commit();
+}
+
+bool DatabaseManager::createProductDailySales()
+{
+    // Igual que sales_daily_summary, pero por producto: top de productos,
+    // velocidad de venta y stock sin movimiento leen filas ya agregadas en
+    // lugar de agrupar sale_items. El costo se toma del precio de compra al
+    // momento de la venta (sale_items.unit_cost), de modo que cancelar resta
+    // exactamente lo que se sumó aunque el precio haya cambiado.
+    QSqlDatabase& db = database();
+    QSqlQuery query(db);
+
+    if (!db.transaction()) {
+        m_lastError = db.lastError().text();
+        return false;
+    }
+
+    const QStringList statements = {
+        "ALTER TABLE sale_items ADD COLUMN unit_cost REAL",
+
+        // Ventas existentes: el precio de compra actual es la mejor aproximación
+        "UPDATE sale_items SET unit_cost = "
+        "(SELECT purchase_price FROM products WHERE products.id = sale_items.product_id) "
+        "WHERE unit_cost IS NULL",
+
+        "CREATE TABLE IF NOT EXISTS product_daily_sales ("
+        "day TEXT NOT NULL,"
+        "product_id INTEGER NOT NULL,"
+        "quantity REAL NOT NULL DEFAULT 0,"
+        "revenue REAL NOT NULL DEFAULT 0,"  // Suma de sale_items.subtotal
+        "cost REAL NOT NULL DEFAULT 0,"     // Suma de quantity * unit_cost
+        "PRIMARY KEY (day, product_id)"
+        ") WITHOUT ROWID",
+
+        // Por producto (última venta, productos sin movimiento)
+        "CREATE INDEX IF NOT EXISTS idx_product_daily_sales_product "
+        "ON product_daily_sales(product_id, day)",
+
+        "INSERT OR REPLACE INTO product_daily_sales (day, product_id, quantity, revenue, cost) "
+        "SELECT s.sale_day, si.product_id, SUM(si.quantity), SUM(si.subtotal), "
+        "       SUM(si.quantity * COALESCE(si.unit_cost, 0)) "
+        "FROM sale_items si "
+        "JOIN sales s ON s.id = si.sale_id "
+        "WHERE s.status = 'COMPLETED' "
+        "GROUP BY s.sale_day, si.product_id",
+
+        // Los items se insertan después de la venta, en la misma transacción
+        "CREATE TRIGGER IF NOT EXISTS trg_sale_items_daily_insert AFTER INSERT ON sale_items "
+        "WHEN (SELECT status FROM sales WHERE id = NEW.sale_id) = 'COMPLETED' BEGIN "
+        "INSERT INTO product_daily_sales (day, product_id, quantity, revenue, cost) "
+        "SELECT sale_day, NEW.product_id, NEW.quantity, NEW.subtotal, "
+        "       NEW.quantity * COALESCE(NEW.unit_cost, 0) "
+        "FROM sales WHERE id = NEW.sale_id "
+        "ON CONFLICT(day, product_id) DO UPDATE SET "
+        "quantity = quantity + excluded.quantity, revenue = revenue + excluded.revenue, "
+        "cost = cost + excluded.cost; "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_sales_product_daily_cancel AFTER UPDATE OF status ON sales "
+        "WHEN OLD.status = 'COMPLETED' AND NEW.status <> 'COMPLETED' BEGIN "
+        "UPDATE product_daily_sales SET "
+        "quantity = quantity - (SELECT SUM(si.quantity) FROM sale_items si "
+        "    WHERE si.sale_id = OLD.id AND si.product_id = product_daily_sales.product_id), "
+        "revenue = revenue - (SELECT SUM(si.subtotal) FROM sale_items si "
+        "    WHERE si.sale_id = OLD.id AND si.product_id = product_daily_sales.product_id), "
+        "cost = cost - (SELECT SUM(si.quantity * COALESCE(si.unit_cost, 0)) FROM sale_items si "
+        "    WHERE si.sale_id = OLD.id AND si.product_id = product_daily_sales.product_id) "
+        "WHERE day = OLD.sale_day "
+        "AND product_id IN (SELECT product_id FROM sale_items WHERE sale_id = OLD.id); "
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_sales_product_daily_complete AFTER UPDATE OF status ON sales "
+        "WHEN OLD.status <> 'COMPLETED' AND NEW.status = 'COMPLETED' BEGIN "
+        "INSERT INTO product_daily_sales (day, product_id, quantity, revenue, cost) "
+        "SELECT NEW.sale_day, product_id, SUM(quantity), SUM(subtotal), "
+        "       SUM(quantity * COALESCE(unit_cost, 0)) "
+        "FROM sale_items WHERE sale_id = NEW.id GROUP BY product_id "
+        "ON CONFLICT(day, product_id) DO UPDATE SET "
+        "quantity = quantity + excluded.quantity, revenue = revenue + excluded.revenue, "
+        "cost = cost + excluded.cost; "
+        "END",
+
+        // BEFORE y no AFTER: el ON DELETE CASCADE de sale_items borra los
+        // items antes de que corran los triggers AFTER DELETE
+        "CREATE TRIGGER IF NOT EXISTS trg_sales_product_daily_delete BEFORE DELETE ON sales "
+        "WHEN OLD.status = 'COMPLETED' BEGIN "
+        "UPDATE product_daily_sales SET "
+        "quantity = quantity - (SELECT SUM(si.quantity) FROM sale_items si "
+        "    WHERE si.sale_id = OLD.id AND si.product_id = product_daily_sales.product_id), "
+        "revenue = revenue - (SELECT SUM(si.subtotal) FROM sale_items si "
+        "    WHERE si.sale_id = OLD.id AND si.product_id = product_daily_sales.product_id), "
+        "cost = cost - (SELECT SUM(si.quantity * COALESCE(si.unit_cost, 0)) FROM sale_items si "
+        "    WHERE si.sale_id = OLD.id AND si.product_id = product_daily_sales.product_id) "
+        "WHERE day = OLD.sale_day "
+        "AND product_id IN (SELECT product_id FROM sale_items WHERE sale_id = OLD.id); "
+        "END"
+    };
+
+    for (const QString& sql : statements) {
+        if (!query.exec(sql)) {
+            m_lastError = query.lastError().text();
+            qCritical() << "Error en migración 10:" << m_lastError;
+            db.rollback();
+            return false;
+        }
+    }
+
+    return db.commit();
+}
+
+bool DatabaseManager::enableIncrementalVacuum()
+{
+    // Sin auto_vacuum el archivo nunca se achica: las páginas libres quedan
+    // en la freelist. El modo solo puede cambiarse reconstruyendo la base
+    // con VACUUM, que no admite transacción; es una operación única.
+    QSqlQuery query(database());
+
+    if (query.exec("PRAGMA auto_vacuum") && query.next() && query.value(0).toInt() == 2) {
+        return true;  // Ya es INCREMENTAL (base nueva, ver runMigrations)
+    }
+    query.finish();
+
+    if (!query.exec("PRAGMA auto_vacuum = INCREMENTAL") || !query.exec("VACUUM")) {
+        m_lastError = query.lastError().text();
+        qCritical() << "Error activando auto_vacuum incremental:" << m_lastError;
+        return false;
+    }
+
+    return true;
+}
+
+bool DatabaseManager::createProductSearchIndex()
+{
+    // Tabla FTS5 con su propio contenido (rowid = products.id) porque incluye
+    // el nombre de la categoría, que no está en products. remove_diacritics
+    // hace que "cafe" encuentre "Café"; los índices de prefijo de 2 y 3
+    // caracteres aceleran la búsqueda mientras se escribe.
+    QSqlDatabase& db = database();
+    QSqlQuery query(db);
+
+    if (!db.transaction()) {
+        m_lastError = db.lastError().text();
+        return false;
+    }
+
+    const QString insertRow =
+        "INSERT INTO products_fts(rowid, name, sku, barcode, description, category_name) "
+        "VALUES (NEW.id, NEW.name, NEW.sku, NEW.barcode, NEW.description, "
+        "(SELECT name FROM categories WHERE id = NEW.category_id)); ";
+
+    const QStringList statements = {
+        "CREATE VIRTUAL TABLE IF NOT EXISTS products_fts USING fts5("
+        "name, sku, barcode, description, category_name, "
+        "tokenize = 'unicode61 remove_diacritics 2', prefix = '2 3')",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_products_fts_insert AFTER INSERT ON products BEGIN "
+        + insertRow +
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_products_fts_update "
+        "AFTER UPDATE OF name, sku, barcode, description, category_id ON products BEGIN "
+        "DELETE FROM products_fts WHERE rowid = OLD.id; "
+        + insertRow +
+        "END",
+
+        "CREATE TRIGGER IF NOT EXISTS trg_products_fts_delete AFTER DELETE ON products BEGIN "
+        "DELETE FROM products_fts WHERE rowid = OLD.id; "
+        "END",
+
+        // Al renombrar una categoría se actualizan sus productos
+        "CREATE TRIGGER IF NOT EXISTS trg_categories_fts_update "
+        "AFTER UPDATE OF name ON categories BEGIN "
+        "UPDATE products_fts SET category_name = NEW.name "
+        "WHERE rowid IN (SELECT id FROM products WHERE category_id = NEW.id); "
+        "END",
+
+        // Cargar los productos existentes
+        "INSERT INTO products_fts(rowid, name, sku, barcode, description, category_name) "
+        "SELECT p.id, p.name, p.sku, p.barcode, p.description, c.name "
+        "FROM products p LEFT JOIN categories c ON p.category_id = c.id"
+    };
+
+    for (const QString& sql : statements) {
+        if (!query.exec(sql)) {
+            m_lastError = query.lastError().text();
+            qCritical() << "Error en migración 4:" << m_lastError;
+            db.rollback();
+            return false;
+        }
+    }
+
+    return db.commit();
+}
+
+bool DatabaseManager::addActiveNameIndex()
+{
+    // Ordenado igual que el cursor (name, id) de ProductRepository::findPage:
+    // cada página es un rango del índice, sin OFFSET ni ordenar en memoria
+    QSqlQuery query(database());
+
+    if (!query.exec("CREATE INDEX IF NOT EXISTS idx_products_active_name "
+                    "ON products(active, name, id)")) {
+        m_lastError = query.lastError().text();
+        qCritical() << "Error en migración 5:" << m_lastError;
+        return false;
+    }
+
+    return true;
+}
+
 bool DatabaseManager::insertSampleData()
 {
     qDebug() << "Insertando datos de ejemplo...";
     
-    QSqlQuery query(m_database);
+    QSqlQuery query(database());
     
     // Verificar si ya hay productos
     query.exec("SELECT COUNT(*) FROM products");
@@ -4,14 +4,23 @@
 #include <QObject>
 #include <QSqlDatabase>
 #include <QSqlError>
+#include <QSqlQuery>
+#include <QHash>
 #include <QMutex>
+#include <QThreadStorage>
+#include <QAtomicInt>
+#include <QStringList>
+#include <functional>
 #include <memory>
+#include <optional>
+
+class MaintenanceScheduler;
 
 /**
  * @brief Gestor centralizado de base de datos (Singleton, thread-safe)
  * 
  * Responsabilidades:
- * - Gestionar conexión única a la base de datos SQLite
+ * - Gestionar el pool de conexiones SQLite (una por hilo)
  * - Ejecutar migraciones automáticas
  * - Proporcionar transacciones seguras
  * - Logging de errores SQL
@@ -36,26 +45,153 @@ public:
     bool initialize(const QString& dbPath = "");
 
     /**
-     * @brief Obtener referencia a la base de datos
-     * @return QSqlDatabase& conexión activa
+     * @brief Obtener la conexión del hilo actual
+     *
+     * QSqlDatabase no puede usarse desde un hilo distinto al que la abrió,
+     * por eso cada hilo recibe su propia conexión al mismo archivo. Se abre
+     * bajo demanda y se cierra automáticamente cuando el hilo termina.
+     * Los repositorios deben usar DatabaseConnection en lugar de este método.
+     *
+     * @return QSqlDatabase& conexión del hilo actual
      */
     QSqlDatabase& database();
 
+    /**
+     * @brief Ruta del archivo de base de datos
+     */
+    QString databasePath() const;
+
+    /**
+     * @brief Cantidad de conexiones abiertas en el pool (todos los hilos)
+     */
+    int openConnectionCount() const;
+
+    /**
+     * @brief Contadores de la caché de sentencias preparadas
+     */
+    struct StatementCacheStats {
+        quint64 hits = 0;
+        quint64 misses = 0;
+
+        double hitRatio() const {
+            const quint64 total = hits + misses;
+            return total > 0 ? static_cast<double>(hits) / total : 0.0;
+        }
+    };
+
+    /**
+     * @brief Aciertos/fallos acumulados de todas las conexiones del pool
+     */
+    StatementCacheStats statementCacheStats() const;
+
+    /**
+     * @brief Perfil de almacenamiento SQLite (pragmas por conexión)
+     *
+     * Perfiles predefinidos:
+     * - "pos-safe":    WAL + synchronous=NORMAL (por defecto, caja)
+     * - "bulk-import": WAL + caché grande, temp_store en memoria y mmap
+     * - "paranoid":    WAL + synchronous=FULL y verificación de celdas
+     */
+    struct StorageProfile {
+        QString name;
+        QString journalMode = "WAL";
+        QString synchronous = "NORMAL";
+        int cacheSizeKb = 8192;        // PRAGMA cache_size = -N (KiB)
+        QString tempStore = "DEFAULT";
+        qint64 mmapSize = 0;           // Bytes; 0 desactiva mmap
+        bool cellSizeCheck = false;
+    };
+
+    /**
+     * @brief Obtener la definición de un perfil predefinido
+     * @return std::nullopt si el nombre no existe
+     */
+    static std::optional<StorageProfile> storageProfile(const QString& name);
+
+    /**
+     * @brief Nombres de los perfiles disponibles
+     */
+    static QStringList storageProfileNames();
+
+    /**
+     * @brief Perfil activo
+     */
+    QString storageProfileName() const;
+
+    /**
+     * @brief Cambiar el perfil activo en tiempo de ejecución
+     *
+     * Se aplica de inmediato a la conexión del hilo actual y al resto de
+     * conexiones la próxima vez que su hilo la use (fuera de transacción).
+     * Útil para envolver trabajos masivos como importaciones.
+     *
+     * @param persist Guardar el perfil en la tabla settings
+     */
+    bool setStorageProfile(const QString& name, bool persist = false);
+
     /**
      * @brief Comenzar transacción
+     *
+     * Las transacciones son anidables por hilo: el primer nivel abre una
+     * transacción real y los siguientes crean un SAVEPOINT. Preferir
+     * TransactionScope, que garantiza el cierre de cada nivel.
      */
     bool beginTransaction();
 
     /**
-     * @brief Confirmar transacción
+     * @brief Confirmar el nivel actual (COMMIT o RELEASE del savepoint)
      */
     bool commit();
 
     /**
-     * @brief Revertir transacción
+     * @brief Revertir el nivel actual (ROLLBACK o ROLLBACK TO del savepoint)
      */
     bool rollback();
 
+    /**
+     * @brief Niveles de transacción abiertos en el hilo actual (0: ninguno)
+     */
+    int transactionDepth();
+
+    /**
+     * @brief Ejecutar una acción cuando la transacción del hilo se confirme
+     *
+     * Para mantener cachés en memoria coherentes con la base: si no hay
+     * transacción se ejecuta de inmediato; si la hay, al hacer el COMMIT
+     * externo. Se descarta si se revierte el nivel (o savepoint) en el que
+     * se registró.
+     */
+    void runAfterCommit(std::function<void()> action);
+
+    /**
+     * @brief Abrir una instantánea de lectura en el hilo actual
+     *
+     * Mientras esté abierta, los DatabaseConnection del hilo usan una
+     * conexión de solo lectura con una transacción de lectura fija: en
+     * modo WAL todas sus consultas ven el mismo punto en el tiempo y no
+     * retrasan los commits de otras conexiones. Es anidable; las
+     * transacciones de escritura siguen usando la conexión normal.
+     * Preferir ReadSnapshot, que garantiza el cierre.
+     */
+    bool beginReadSnapshot();
+
+    /**
+     * @brief Cerrar el nivel de instantánea abierto por beginReadSnapshot()
+     */
+    void endReadSnapshot();
+
+    /**
+     * @brief Momento (ms desde epoch) del último commit de escritura
+     *
+     * Lo usa MaintenanceScheduler para detectar períodos sin ventas.
+     */
+    qint64 lastWriteActivity() const;
+
+    /**
+     * @brief Programador de mantenimiento (ANALYZE, vacuum, checkpoint)
+     */
+    MaintenanceScheduler* maintenance() const;
+
     /**
      * @brief Verificar si la base de datos está conectada
      */
@@ -78,6 +214,37 @@ signals:
     void databaseReady();
 
 private:
+    friend class DatabaseConnection;
+
+    /**
+     * @brief Sentencia preparada que vive en la caché de una conexión
+     *
+     * inUse evita entregar la misma sentencia a dos consultas anidadas.
+     */
+    struct CachedStatement {
+        QSqlQuery query;
+        bool inUse = false;
+        explicit CachedStatement(const QSqlDatabase& db) : query(db) {}
+    };
+
+    /**
+     * @brief Conexión propia de un hilo
+     *
+     * QThreadStorage la destruye en el mismo hilo cuando éste termina,
+     * lo que cierra y elimina la conexión con nombre.
+     */
+    struct ThreadConnection {
+        QString name;
+        QSqlDatabase db;
+        QHash<QString, CachedStatement*> statements;  // Caché por texto SQL
+        StatementCacheStats statementStats;
+        int profileGeneration = -1;  // Versión del perfil aplicado
+        int transactionDepth = 0;  // 1: transacción, >1: savepoints anidados
+        int snapshotDepth = 0;     // Solo conexiones de instantánea de lectura
+        QList<QPair<int, std::function<void()>>> afterCommit;  // (nivel, acción)
+        ~ThreadConnection();
+    };
+
     // Constructor privado (Singleton)
     explicit DatabaseManager(QObject *parent = nullptr);
     ~DatabaseManager();
@@ -91,11 +258,101 @@ private:
      */
     bool runMigrations();
 
+    /**
+     * @brief Obtener (o abrir) la conexión del hilo actual
+     */
+    ThreadConnection* threadConnection();
+
+    /**
+     * @brief Obtener (o abrir) la conexión de solo lectura del hilo actual
+     */
+    ThreadConnection* snapshotConnection();
+
+    /**
+     * @brief Conexión que deben usar las consultas del hilo actual
+     *
+     * threadConnection() si tiene una transacción abierta (aunque haya una
+     * instantánea: las escrituras de un TransactionScope no pueden ir a la
+     * conexión de solo lectura); si no, la instantánea de lectura si hay
+     * una abierta, o threadConnection().
+     */
+    ThreadConnection* activeConnection();
+
+    /**
+     * @brief Aplicar la configuración común a una conexión recién abierta
+     *
+     * Todas las conexiones del pool deben quedar configuradas igual
+     * (foreign keys, pragmas), sin importar el hilo que las abra.
+     */
+    bool configureConnection(QSqlDatabase& db);
+
+    /**
+     * @brief Aplicar los pragmas del perfil activo a una conexión
+     */
+    bool applyStorageProfile(ThreadConnection* connection);
+
+    /**
+     * @brief Cargar el perfil guardado en settings (por defecto "pos-safe")
+     */
+    void loadStorageProfile();
+
+    /**
+     * @brief Obtener de la caché (o preparar) la sentencia para un SQL
+     * @param inUse Recibe el indicador a liberar, o nullptr si la sentencia
+     *              devuelta es temporal y el llamador debe eliminarla
+     */
+    QSqlQuery* acquireStatement(ThreadConnection* connection, const QString& sql, bool*& inUse);
+
     /**
      * @brief Crear tablas iniciales
      */
     bool createTables();
 
+    /**
+     * @brief Migración 2: columnas de día indexadas en sales y stock_movements
+     */
+    bool addDayColumns();
+
+    /**
+     * @brief Migración 3: auto_vacuum incremental para liberar espacio sin VACUUM completo
+     */
+    bool enableIncrementalVacuum();
+
+    /**
+     * @brief Migración 4: tabla FTS5 products_fts y triggers de sincronización
+     */
+    bool createProductSearchIndex();
+
+    /**
+     * @brief Migración 5: índice (active, name, id) para el listado paginado de productos
+     */
+    bool addActiveNameIndex();
+
+    /**
+     * @brief Migración 6: columna generada low_stock con índice parcial
+     */
+    bool addLowStockIndex();
+
+    /**
+     * @brief Migración 7: registro de cambios product_changes y sus triggers
+     */
+    bool createProductChangeLog();
+
+    /**
+     * @brief Migración 8: tabla invoice_sequences (numeración por serie y día)
+     */
+    bool createInvoiceSequences();
+
+    /**
+     * @brief Migración 9: tabla sales_daily_summary, carga inicial y triggers
+     */
+    bool createSalesDailySummary();
+
+    /**
+     * @brief Migración 10: sale_items.unit_cost y tabla product_daily_sales con sus triggers
+     */
+    bool createProductDailySales();
+
     /**
      * @brief Verificar y actualizar versión del esquema
      */
@@ -107,7 +364,18 @@ private:
      */
     bool insertSampleData();
 
-    QSqlDatabase m_database;
+    QString m_databasePath;
+    QThreadStorage<ThreadConnection*> m_connections;  // Pool: una conexión por hilo
+    QThreadStorage<ThreadConnection*> m_snapshotConnections;  // Solo lectura, bajo demanda
+    QAtomicInteger<qint64> m_lastWriteMs = 0;
+    std::unique_ptr<MaintenanceScheduler> m_maintenance;
+    QAtomicInt m_connectionSerial;
+    QAtomicInt m_openConnections;
+    QAtomicInteger<quint64> m_statementHits;
+    QAtomicInteger<quint64> m_statementMisses;
+    StorageProfile m_storageProfile;
+    QAtomicInt m_profileGeneration;
+    mutable QMutex m_profileMutex;
     QString m_lastError;
     mutable QMutex m_mutex;  // Para thread-safety
     bool m_initialized;
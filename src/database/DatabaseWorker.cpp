@@ -0,0 +1,104 @@
+#include "DatabaseWorker.h"
+#include <QCoreApplication>
+#include <QDebug>
+
+DatabaseWorker::DatabaseWorker(const QString& threadName, QObject *parent)
+    : QObject(parent)
+    , m_threadName(threadName)
+{
+    // Detener antes de que se destruya el resto de singletons
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                this, &DatabaseWorker::shutdown);
+    }
+}
+
+DatabaseWorker::~DatabaseWorker()
+{
+    shutdown();
+}
+
+DatabaseWorker& DatabaseWorker::instance()
+{
+    static DatabaseWorker instance("DatabaseWorker");
+    return instance;
+}
+
+DatabaseWorker& DatabaseWorker::readerInstance()
+{
+    static DatabaseWorker instance("DatabaseReader");
+    return instance;
+}
+
+int DatabaseWorker::pendingJobs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_jobs.size();
+}
+
+bool DatabaseWorker::isWorkerThread() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_thread && QThread::currentThread() == m_thread;
+}
+
+void DatabaseWorker::shutdown()
+{
+    QThread* thread = nullptr;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_thread || m_stopping) {
+            return;
+        }
+        m_stopping = true;
+        thread = m_thread;
+        m_jobAvailable.wakeAll();
+    }
+
+    // Los trabajos ya encolados (p. ej. una venta) se terminan antes de salir
+    thread->wait();
+    delete thread;
+
+    QMutexLocker locker(&m_mutex);
+    m_thread = nullptr;
+    qDebug() << "Hilo de base de datos detenido:" << m_threadName;
+}
+
+void DatabaseWorker::enqueue(std::function<void()> job)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_stopping) {
+        qWarning() << "DatabaseWorker detenido, trabajo descartado";
+        return;  // La promesa se destruye y el QFuture queda cancelado
+    }
+
+    m_jobs.enqueue(std::move(job));
+
+    if (!m_thread) {
+        m_thread = QThread::create([this]() { processJobs(); });
+        m_thread->setObjectName(m_threadName);
+        m_thread->start();
+    }
+
+    m_jobAvailable.wakeOne();
+}
+
+void DatabaseWorker::processJobs()
+{
+    forever {
+        std::function<void()> job;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_jobs.isEmpty() && !m_stopping) {
+                m_jobAvailable.wait(&m_mutex);
+            }
+            if (m_jobs.isEmpty()) {
+                return;  // Detenido y sin trabajos pendientes
+            }
+            job = m_jobs.dequeue();
+        }
+
+        job();
+    }
+}
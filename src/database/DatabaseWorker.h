@@ -0,0 +1,119 @@
+#ifndef DATABASEWORKER_H
+#define DATABASEWORKER_H
+
+#include <QObject>
+#include <QThread>
+#include <QString>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QFuture>
+#include <QPromise>
+#include <functional>
+#include <memory>
+#include <type_traits>
+
+/**
+ * @brief Hilo dedicado para trabajos de base de datos (Singleton)
+ *
+ * Ejecuta en orden (FIFO) los trabajos encolados, sobre un único hilo que
+ * tiene su propia conexión del pool. Así las consultas pesadas (reportes,
+ * listados, importaciones) no bloquean el hilo de QML.
+ *
+ * Uso desde un ViewModel:
+ * @code
+ * DatabaseWorker::instance().run([]() { return SaleRepository().findToday(); })
+ *     .then(this, [this](const QList<Sale>& sales) { ... });
+ * @endcode
+ *
+ * La continuación con contexto (then(this, ...)) se ejecuta en el hilo del
+ * objeto, por lo que puede tocar propiedades de QML sin riesgo.
+ */
+class DatabaseWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Obtener instancia única del worker
+     */
+    static DatabaseWorker& instance();
+
+    /**
+     * @brief Worker para lecturas largas (reportes, dashboard)
+     *
+     * Tiene su propio hilo, así un reporte no retrasa los trabajos
+     * encolados en instance() (p. ej. createSaleAsync). Sus trabajos
+     * deberían abrir una ReadSnapshot.
+     */
+    static DatabaseWorker& readerInstance();
+
+    /**
+     * @brief Encolar un trabajo y obtener un QFuture con su resultado
+     *
+     * El trabajo se ejecuta en el hilo de base de datos. Si el worker ya
+     * se detuvo, el QFuture queda cancelado.
+     */
+    template <typename Function>
+    auto run(Function function) -> QFuture<std::invoke_result_t<Function>>
+    {
+        using Result = std::invoke_result_t<Function>;
+
+        auto promise = std::make_shared<QPromise<Result>>();
+        QFuture<Result> future = promise->future();
+
+        enqueue([promise, function]() mutable {
+            promise->start();
+            if constexpr (std::is_void_v<Result>) {
+                function();
+            } else {
+                promise->addResult(function());
+            }
+            promise->finish();
+        });
+
+        return future;
+    }
+
+    /**
+     * @brief Cantidad de trabajos en espera
+     */
+    int pendingJobs() const;
+
+    /**
+     * @brief Verificar si el hilo actual es el hilo de base de datos
+     */
+    bool isWorkerThread() const;
+
+public slots:
+    /**
+     * @brief Terminar los trabajos pendientes y detener el hilo
+     */
+    void shutdown();
+
+private:
+    explicit DatabaseWorker(const QString& threadName, QObject *parent = nullptr);
+    ~DatabaseWorker();
+
+    DatabaseWorker(const DatabaseWorker&) = delete;
+    DatabaseWorker& operator=(const DatabaseWorker&) = delete;
+
+    /**
+     * @brief Agregar un trabajo a la cola (arranca el hilo si hace falta)
+     */
+    void enqueue(std::function<void()> job);
+
+    /**
+     * @brief Bucle del hilo: toma trabajos de la cola hasta que se detiene
+     */
+    void processJobs();
+
+    QString m_threadName;
+    QThread* m_thread = nullptr;
+    QQueue<std::function<void()>> m_jobs;
+    mutable QMutex m_mutex;
+    QWaitCondition m_jobAvailable;
+    bool m_stopping = false;
+};
+
+#endif // DATABASEWORKER_H
@@ -0,0 +1,231 @@
+#include "MaintenanceScheduler.h"
+#include "DatabaseManager.h"
+#include "DatabaseWorker.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QDebug>
+
+namespace {
+// Frecuencia de la verificación y separación mínima entre ejecuciones completas
+constexpr int kCheckIntervalMs = 60 * 1000;
+constexpr qint64 kMinRunIntervalMs = 6LL * 60 * 60 * 1000;
+
+// Límites por paso: ANALYZE muestrea filas por índice, el vacuum libera por tramos
+constexpr int kAnalysisLimit = 1000;
+constexpr int kVacuumPagesPerSlice = 256;
+constexpr int kMaxVacuumSlices = 64;
+}
+
+MaintenanceScheduler::MaintenanceScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_idleTimer.setInterval(kCheckIntervalMs);
+    connect(&m_idleTimer, &QTimer::timeout, this, &MaintenanceScheduler::checkIdle);
+}
+
+void MaintenanceScheduler::start()
+{
+    QSqlQuery query(DatabaseManager::instance().database());
+
+    if (query.exec("SELECT value FROM settings WHERE key = 'maintenance_idle_minutes'")
+        && query.next()) {
+        m_idleMinutes = qMax(1, query.value(0).toInt());
+    }
+
+    if (query.exec("SELECT value FROM settings WHERE key = 'last_maintenance_at'")
+        && query.next()) {
+        m_lastRunMs = query.value(0).toLongLong();
+    }
+
+    m_idleTimer.start();
+    qDebug() << "Mantenimiento programado tras" << m_idleMinutes << "minutos sin actividad";
+}
+
+void MaintenanceScheduler::stop()
+{
+    m_idleTimer.stop();
+}
+
+bool MaintenanceScheduler::isRunning() const
+{
+    return m_running;
+}
+
+int MaintenanceScheduler::idleMinutes() const
+{
+    return m_idleMinutes;
+}
+
+void MaintenanceScheduler::checkIdle()
+{
+    if (m_running) {
+        return;
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 idleMs = now - DatabaseManager::instance().lastWriteActivity();
+
+    if (idleMs >= m_idleMinutes * 60LL * 1000 && now - m_lastRunMs >= kMinRunIntervalMs) {
+        qDebug() << "Sin actividad por" << idleMs / 60000 << "minutos, iniciando mantenimiento";
+        runNow();
+    }
+}
+
+bool MaintenanceScheduler::runNow()
+{
+    if (m_running) {
+        return false;
+    }
+
+    m_running = true;
+
+    auto run = std::make_shared<Run>();
+    run->startedAtMs = QDateTime::currentMSecsSinceEpoch();
+    run->bytesBefore = databaseBytes();
+    run->timer.start();
+
+    scheduleStep(run);
+    return true;
+}
+
+void MaintenanceScheduler::scheduleStep(std::shared_ptr<Run> run)
+{
+    // La continuación vuelve a este hilo antes de encolar el siguiente paso,
+    // así los trabajos encolados mientras tanto (ventas) se atienden primero
+    DatabaseWorker::instance().run([run]() {
+        return runStep(*run);
+    }).then(this, [this, run](bool pending) {
+        if (pending) {
+            scheduleStep(run);
+        } else {
+            finish(run);
+        }
+    });
+}
+
+bool MaintenanceScheduler::runStep(Run& run)
+{
+    // Hubo escrituras desde que empezó: ceder y reintentar en el próximo período inactivo
+    if (DatabaseManager::instance().lastWriteActivity() > run.startedAtMs) {
+        run.interrupted = true;
+        return false;
+    }
+
+    QSqlQuery query(DatabaseManager::instance().database());
+
+    switch (run.step) {
+    case CompactChanges:
+        // changesSince() solo necesita la última versión de cada producto
+        if (!query.exec("DELETE FROM product_changes WHERE version NOT IN "
+                        "(SELECT MAX(version) FROM product_changes GROUP BY product_id)")) {
+            qWarning() << "Mantenimiento: error compactando product_changes:" << query.lastError().text();
+        } else {
+            run.completedSteps << QString("product_changes -%1").arg(query.numRowsAffected());
+        }
+        run.step = Analyze;
+        return true;
+
+    case Analyze:
+        query.exec(QString("PRAGMA analysis_limit = %1").arg(kAnalysisLimit));
+        if (!query.exec("ANALYZE")) {
+            qWarning() << "Mantenimiento: error en ANALYZE:" << query.lastError().text();
+        } else {
+            run.completedSteps << "analyze";
+        }
+        run.step = Optimize;
+        return true;
+
+    case Optimize:
+        if (!query.exec("PRAGMA optimize")) {
+            qWarning() << "Mantenimiento: error en PRAGMA optimize:" << query.lastError().text();
+        } else {
+            run.completedSteps << "optimize";
+        }
+        run.step = IncrementalVacuum;
+        return true;
+
+    case IncrementalVacuum: {
+        qint64 freePages = 0;
+        if (query.exec("PRAGMA freelist_count") && query.next()) {
+            freePages = query.value(0).toLongLong();
+        }
+        query.finish();
+
+        // Un tramo por paso; incremental_vacuum no hace nada si auto_vacuum != INCREMENTAL.
+        // SQLite libera una página por cada sqlite3_step y QSqlQuery::exec() avanza
+        // una sola vez una sentencia sin columnas: se ejecuta una vez por página.
+        if (freePages > 0 && run.vacuumSlices < kMaxVacuumSlices) {
+            query.prepare("PRAGMA incremental_vacuum");
+            const qint64 pages = qMin<qint64>(freePages, kVacuumPagesPerSlice);
+            for (qint64 i = 0; i < pages; ++i) {
+                if (!query.exec()) {
+                    qWarning() << "Mantenimiento: error en incremental_vacuum:" << query.lastError().text();
+                    run.step = Checkpoint;
+                    return true;
+                }
+            }
+            run.vacuumSlices++;
+            return true;
+        }
+
+        if (run.vacuumSlices > 0) {
+            run.completedSteps << QString("incremental_vacuum x%1").arg(run.vacuumSlices);
+        }
+        run.step = Checkpoint;
+        return true;
+    }
+
+    case Checkpoint:
+        // Copia el WAL a la base y lo trunca; sin lectores activos no espera
+        if (query.exec("PRAGMA wal_checkpoint(TRUNCATE)") && query.next()) {
+            if (query.value(0).toInt() != 0) {
+                qDebug() << "Mantenimiento: checkpoint parcial, hay lectores activos";
+            }
+            run.completedSteps << "wal_checkpoint";
+        } else {
+            qWarning() << "Mantenimiento: error en wal_checkpoint:" << query.lastError().text();
+        }
+        run.step = Done;
+        return false;
+
+    default:
+        return false;
+    }
+}
+
+void MaintenanceScheduler::finish(const std::shared_ptr<Run>& run)
+{
+    m_running = false;
+
+    const qint64 durationMs = run->timer.elapsed();
+    const qint64 bytesReclaimed = run->bytesBefore - databaseBytes();
+    const bool completed = !run->interrupted;
+
+    if (completed) {
+        m_lastRunMs = QDateTime::currentMSecsSinceEpoch();
+
+        QSqlQuery query(DatabaseManager::instance().database());
+        query.prepare("INSERT OR REPLACE INTO settings (key, value, updated_at) "
+                      "VALUES ('last_maintenance_at', :value, datetime('now'))");
+        query.bindValue(":value", QString::number(m_lastRunMs));
+        if (!query.exec()) {
+            qWarning() << "Error guardando fecha de mantenimiento:" << query.lastError().text();
+        }
+
+        qDebug() << "Mantenimiento completado en" << durationMs << "ms,"
+                 << bytesReclaimed / 1024 << "KB recuperados -" << run->completedSteps.join(", ");
+    } else {
+        qDebug() << "Mantenimiento interrumpido por actividad tras" << durationMs << "ms,"
+                 << bytesReclaimed / 1024 << "KB recuperados -" << run->completedSteps.join(", ");
+    }
+
+    emit maintenanceFinished(durationMs, bytesReclaimed, completed);
+}
+
+qint64 MaintenanceScheduler::databaseBytes()
+{
+    const QString path = DatabaseManager::instance().databasePath();
+    return QFileInfo(path).size() + QFileInfo(path + "-wal").size();
+}
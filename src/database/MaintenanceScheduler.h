@@ -0,0 +1,105 @@
+#ifndef MAINTENANCESCHEDULER_H
+#define MAINTENANCESCHEDULER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <memory>
+
+/**
+ * @brief Mantenimiento de la base de datos en tiempos muertos
+ *
+ * Cuando no hay escrituras (ventas, ajustes) durante idleMinutes() minutos,
+ * ejecuta en el hilo de base de datos:
+ * - Compactación de product_changes (última versión de cada producto)
+ * - ANALYZE acotado (analysis_limit) y PRAGMA optimize
+ * - PRAGMA incremental_vacuum por tramos de páginas
+ * - PRAGMA wal_checkpoint(TRUNCATE)
+ *
+ * Cada paso es un trabajo separado en DatabaseWorker, de modo que una venta
+ * encolada se atiende entre pasos; si hubo escrituras desde que empezó, el
+ * resto se cancela y se reintenta en el próximo período inactivo.
+ *
+ * Lo crea y arranca DatabaseManager::initialize().
+ */
+class MaintenanceScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MaintenanceScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief Comenzar a vigilar los períodos inactivos
+     *
+     * Lee de settings maintenance_idle_minutes y la fecha de la última
+     * ejecución (last_maintenance_at).
+     */
+    void start();
+
+    /**
+     * @brief Dejar de vigilar (no interrumpe un paso en curso)
+     */
+    void stop();
+
+    /**
+     * @brief Ejecutar el mantenimiento ahora, sin esperar inactividad
+     * @return false si ya hay uno en curso
+     */
+    bool runNow();
+
+    bool isRunning() const;
+    int idleMinutes() const;
+
+signals:
+    /**
+     * @brief Emitida al terminar o cancelarse una ejecución
+     * @param completed false si se interrumpió por actividad
+     */
+    void maintenanceFinished(qint64 durationMs, qint64 bytesReclaimed, bool completed);
+
+private slots:
+    void checkIdle();
+
+private:
+    enum Step { CompactChanges, Analyze, Optimize, IncrementalVacuum, Checkpoint, Done };
+
+    /**
+     * @brief Estado de una ejecución, compartido entre pasos
+     */
+    struct Run {
+        qint64 startedAtMs = 0;
+        qint64 bytesBefore = 0;
+        int step = CompactChanges;
+        int vacuumSlices = 0;
+        bool interrupted = false;
+        QStringList completedSteps;
+        QElapsedTimer timer;
+    };
+
+    /**
+     * @brief Encolar el próximo paso en el hilo de base de datos
+     */
+    void scheduleStep(std::shared_ptr<Run> run);
+
+    /**
+     * @brief Ejecutar un tramo acotado del paso actual (hilo de base de datos)
+     * @return true si quedan pasos pendientes
+     */
+    static bool runStep(Run& run);
+
+    void finish(const std::shared_ptr<Run>& run);
+
+    /**
+     * @brief Tamaño en disco de la base de datos y su WAL
+     */
+    static qint64 databaseBytes();
+
+    QTimer m_idleTimer;
+    int m_idleMinutes = 10;
+    qint64 m_lastRunMs = 0;
+    bool m_running = false;
+};
+
+#endif // MAINTENANCESCHEDULER_H
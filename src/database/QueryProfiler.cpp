@@ -0,0 +1,367 @@
+#include "QueryProfiler.h"
+#include "../utils/UiStallMonitor.h"
+#include <QSqlQuery>
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QTextStream>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+// El log rota al superar este tamaño; se conservan kSlowLogKeep archivos antiguos
+constexpr qint64 kSlowLogMaxBytes = 1024 * 1024;
+constexpr int kSlowLogKeep = 5;
+
+// Consultas por bloqueo de UI que se detallan en el log
+constexpr int kStallTopQueries = 3;
+}
+
+QueryProfiler& QueryProfiler::instance()
+{
+    static QueryProfiler instance;
+    return instance;
+}
+
+QueryProfiler::QueryProfiler(QObject *parent)
+    : QObject(parent)
+{
+    // Directa: la ventana de consultas se lee antes de que avance el latido
+    connect(&UiStallMonitor::instance(), &UiStallMonitor::stallDetected,
+            this, &QueryProfiler::recordUiStall, Qt::DirectConnection);
+}
+
+const QList<double>& QueryProfiler::bucketBoundsMs()
+{
+    // El último bucket recoge todo lo que supere 1 s
+    static const QList<double> bounds = {0.1, 0.5, 1, 5, 10, 50, 100, 500, 1000,
+                                         std::numeric_limits<double>::infinity()};
+    return bounds;
+}
+
+void QueryProfiler::record(const QSqlDatabase& db, const QSqlQuery& query, const char* caller,
+                           qint64 elapsedNs, bool success, int rows)
+{
+    const QString sql = query.lastQuery().simplified();
+    const QString callerName = QString::fromUtf8(caller);
+    const double elapsedMs = elapsedNs / 1e6;
+    const UiStallMonitor& monitor = UiStallMonitor::instance();
+    const bool uiThread = monitor.isUiThread();
+
+    bool slow = false;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        StatementStats& stats = m_stats[sql];
+        if (stats.executions == 0) {
+            stats.sql = sql;
+            stats.histogram.fill(0, bucketBoundsMs().size());
+        }
+
+        stats.executions++;
+        stats.totalNs += elapsedNs;
+        stats.maxNs = std::max(stats.maxNs, elapsedNs);
+        if (!success) {
+            stats.failures++;
+        }
+        if (rows > 0) {
+            stats.rowsAffected += rows;
+        }
+        stats.callers.insert(callerName);
+
+        if (uiThread) {
+            if (m_uiWindowBeat != monitor.beat()) {
+                m_uiWindowBeat = monitor.beat();
+                m_uiWindowQueries.clear();
+            }
+            m_uiWindowQueries[sql] += elapsedNs;
+        }
+
+        const QList<double>& bounds = bucketBoundsMs();
+        const auto bucket = std::lower_bound(bounds.cbegin(), bounds.cend(), elapsedMs);
+        stats.histogram[std::distance(bounds.cbegin(), bucket)]++;
+
+        slow = elapsedMs >= m_slowThresholdMs;
+        if (slow) {
+            stats.slowExecutions++;
+        }
+    }
+
+    if (!slow) {
+        return;
+    }
+
+    // El plan se obtiene fuera del mutex: ejecuta otra sentencia en la conexión
+    const QStringList plan = explainQueryPlan(db, query);
+
+    QString entry;
+    QTextStream out(&entry);
+    out << QDateTime::currentDateTime().toString(Qt::ISODateWithMs)
+        << " | " << QString::number(elapsedMs, 'f', 2) << " ms"
+        << " | filas: " << (rows >= 0 ? QString::number(rows) : QStringLiteral("?"))
+        << " | " << callerName << "\n"
+        << "  SQL: " << sql << "\n";
+    if (!success) {
+        out << "  Error: " << query.lastError().text() << "\n";
+    }
+    for (const QString& step : plan) {
+        out << "  PLAN: " << step << "\n";
+    }
+    out.flush();
+
+    qWarning() << "Consulta lenta (" << elapsedMs << "ms ) en" << callerName;
+    writeSlowLog(entry);
+
+    emit slowQueryDetected(sql, elapsedMs, callerName);
+}
+
+QStringList QueryProfiler::explainQueryPlan(const QSqlDatabase& db, const QSqlQuery& query) const
+{
+    QStringList plan;
+
+    const QString sql = query.lastQuery().trimmed();
+    if (!sql.startsWith("SELECT", Qt::CaseInsensitive)
+        && !sql.startsWith("WITH", Qt::CaseInsensitive)
+        && !sql.startsWith("INSERT", Qt::CaseInsensitive)
+        && !sql.startsWith("UPDATE", Qt::CaseInsensitive)
+        && !sql.startsWith("DELETE", Qt::CaseInsensitive)) {
+        return plan;
+    }
+
+    QSqlQuery explain(db);
+    explain.setForwardOnly(true);
+    if (!explain.prepare("EXPLAIN QUERY PLAN " + sql)) {
+        plan << "(no disponible: " + explain.lastError().text() + ")";
+        return plan;
+    }
+
+    // Mismos valores enlazados, por posición
+    const QVariantList values = query.boundValues();
+    for (int i = 0; i < values.size(); ++i) {
+        explain.bindValue(i, values.at(i));
+    }
+
+    if (!explain.exec()) {
+        plan << "(no disponible: " + explain.lastError().text() + ")";
+        return plan;
+    }
+
+    // Columnas: id, parent, notused, detail
+    while (explain.next()) {
+        plan << QString("%1 <- %2: %3")
+                    .arg(explain.value(0).toInt())
+                    .arg(explain.value(1).toInt())
+                    .arg(explain.value(3).toString());
+    }
+
+    return plan;
+}
+
+void QueryProfiler::writeSlowLog(const QString& entry)
+{
+    QMutexLocker locker(&m_logMutex);
+
+    QString logPath = slowLogPath();
+    if (logPath.isEmpty()) {
+        return;
+    }
+
+    QFileInfo info(logPath);
+    QDir().mkpath(info.absolutePath());
+
+    // Rotación: slow_queries.log -> .1 -> .2 ... -> .kSlowLogKeep (se descarta)
+    if (info.exists() && info.size() >= kSlowLogMaxBytes) {
+        QFile::remove(QString("%1.%2").arg(logPath).arg(kSlowLogKeep));
+        for (int i = kSlowLogKeep - 1; i >= 1; --i) {
+            QFile::rename(QString("%1.%2").arg(logPath).arg(i),
+                          QString("%1.%2").arg(logPath).arg(i + 1));
+        }
+        QFile::rename(logPath, logPath + ".1");
+    }
+
+    QFile file(logPath);
+    if (!file.open(QIODevice::Append | QIODevice::Text)) {
+        qWarning() << "No se pudo escribir el log de consultas lentas:" << file.errorString();
+        return;
+    }
+    file.write(entry.toUtf8());
+}
+
+int QueryProfiler::slowThresholdMs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_slowThresholdMs;
+}
+
+void QueryProfiler::setSlowThresholdMs(int thresholdMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_slowThresholdMs = std::max(0, thresholdMs);
+}
+
+void QueryProfiler::loadSettings(const QSqlDatabase& db)
+{
+    {
+        QMutexLocker locker(&m_logMutex);
+        // El log vive junto a la base de datos
+        m_logPath = QFileInfo(db.databaseName()).absolutePath() + "/logs/slow_queries.log";
+    }
+
+    QSqlQuery query(db);
+    if (query.exec("SELECT value FROM settings WHERE key = 'slow_query_threshold_ms'")
+        && query.next()) {
+        bool ok = false;
+        const int threshold = query.value(0).toInt(&ok);
+        if (ok) {
+            setSlowThresholdMs(threshold);
+        } else {
+            qWarning() << "Umbral de consultas lentas inválido:" << query.value(0).toString();
+        }
+    }
+
+    qDebug() << "Umbral de consultas lentas:" << slowThresholdMs() << "ms";
+}
+
+void QueryProfiler::recordUiStall(double stallMs)
+{
+    QList<std::pair<QString, qint64>> queries;
+    qint64 queryNs = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        // Una ventana de un latido anterior no pertenece a este bloqueo
+        if (m_uiWindowBeat == UiStallMonitor::instance().beat()) {
+            for (auto it = m_uiWindowQueries.cbegin(); it != m_uiWindowQueries.cend(); ++it) {
+                queryNs += it.value();
+                queries.append({it.key(), it.value()});
+                m_stats[it.key()].uiStallNs += it.value();
+            }
+        }
+        m_uiWindowQueries.clear();
+
+        const qint64 stallNs = static_cast<qint64>(stallMs * 1e6);
+        m_uiStalls++;
+        m_uiStallTotalNs += stallNs;
+        m_uiStallMaxNs = std::max(m_uiStallMaxNs, stallNs);
+        m_uiStallQueryNs += queryNs;
+    }
+
+    std::sort(queries.begin(), queries.end(), [](const auto& a, const auto& b) {
+        return a.second > b.second;
+    });
+
+    const double queryMs = queryNs / 1e6;
+
+    QString entry;
+    QTextStream out(&entry);
+    out << QDateTime::currentDateTime().toString(Qt::ISODateWithMs)
+        << " | BLOQUEO DE UI " << QString::number(stallMs, 'f', 2) << " ms"
+        << " | consultas en el hilo de UI: " << QString::number(queryMs, 'f', 2) << " ms\n";
+    for (int i = 0; i < queries.size() && i < kStallTopQueries; ++i) {
+        out << "  SQL (" << QString::number(queries[i].second / 1e6, 'f', 2) << " ms): "
+            << queries[i].first << "\n";
+    }
+    out.flush();
+
+    writeSlowLog(entry);
+
+    emit uiStallDetected(stallMs, queryMs);
+}
+
+QString QueryProfiler::slowLogPath() const
+{
+    QMutexLocker locker(&m_logMutex);
+    return m_logPath;
+}
+
+QJsonObject QueryProfiler::toJson() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonArray bounds;
+    for (double bound : bucketBoundsMs()) {
+        // El último límite es "infinito": JSON no lo representa
+        bounds.append(std::isinf(bound) ? QJsonValue("inf") : QJsonValue(bound));
+    }
+
+    // Ordenar por tiempo total para mostrar primero las más costosas
+    QList<const StatementStats*> ordered;
+    ordered.reserve(m_stats.size());
+    for (const StatementStats& stats : m_stats) {
+        ordered.append(&stats);
+    }
+    std::sort(ordered.begin(), ordered.end(), [](const StatementStats* a, const StatementStats* b) {
+        return a->totalNs > b->totalNs;
+    });
+
+    QJsonArray statements;
+    for (const StatementStats* stats : ordered) {
+        QJsonArray histogram;
+        for (quint64 count : stats->histogram) {
+            histogram.append(static_cast<qint64>(count));
+        }
+
+        QStringList callers(stats->callers.cbegin(), stats->callers.cend());
+        callers.sort();
+
+        QJsonObject entry;
+        entry["sql"] = stats->sql;
+        entry["executions"] = static_cast<qint64>(stats->executions);
+        entry["failures"] = static_cast<qint64>(stats->failures);
+        entry["slowExecutions"] = static_cast<qint64>(stats->slowExecutions);
+        entry["totalMs"] = stats->totalNs / 1e6;
+        entry["avgMs"] = stats->totalNs / 1e6 / stats->executions;
+        entry["maxMs"] = stats->maxNs / 1e6;
+        entry["rowsAffected"] = stats->rowsAffected;
+        entry["uiStallMs"] = stats->uiStallNs / 1e6;
+        entry["histogram"] = histogram;
+        entry["callers"] = QJsonArray::fromStringList(callers);
+        statements.append(entry);
+    }
+
+    QJsonObject root;
+    root["generatedAt"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    root["slowThresholdMs"] = m_slowThresholdMs;
+    root["bucketBoundsMs"] = bounds;
+    root["statements"] = statements;
+
+    QJsonObject uiStalls;
+    uiStalls["thresholdMs"] = UiStallMonitor::instance().thresholdMs();
+    uiStalls["count"] = static_cast<qint64>(m_uiStalls);
+    uiStalls["totalMs"] = m_uiStallTotalNs / 1e6;
+    uiStalls["maxMs"] = m_uiStallMaxNs / 1e6;
+    uiStalls["queryMs"] = m_uiStallQueryNs / 1e6;
+    root["uiStalls"] = uiStalls;
+    return root;
+}
+
+bool QueryProfiler::dumpJson(const QString& filePath) const
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "No se pudo escribir el volcado de consultas:" << file.errorString();
+        return false;
+    }
+
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+    qDebug() << "Estadísticas de consultas guardadas en:" << filePath;
+    return true;
+}
+
+void QueryProfiler::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats.clear();
+    m_uiWindowQueries.clear();
+    m_uiStalls = 0;
+    m_uiStallTotalNs = 0;
+    m_uiStallMaxNs = 0;
+    m_uiStallQueryNs = 0;
+}
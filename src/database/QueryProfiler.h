@@ -0,0 +1,142 @@
+#ifndef QUERYPROFILER_H
+#define QUERYPROFILER_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QJsonObject>
+
+class QSqlQuery;
+class QSqlDatabase;
+
+/**
+ * @brief Instrumentación de consultas SQL (Singleton, thread-safe)
+ *
+ * Responsabilidades:
+ * - Medir tiempo, filas y llamador de cada ejecución (DatabaseConnection::exec)
+ * - Mantener un histograma de latencias por sentencia
+ * - Escribir las consultas lentas, con su EXPLAIN QUERY PLAN, en un
+ *   log rotativo (AppData/logs/slow_queries.log)
+ * - Atribuir a cada bloqueo del hilo de UI (UiStallMonitor) las consultas
+ *   que ese hilo ejecutó mientras duraba
+ * - Exportar las estadísticas como JSON para diagnóstico
+ */
+class QueryProfiler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Estadísticas acumuladas de una sentencia
+     */
+    struct StatementStats {
+        QString sql;
+        quint64 executions = 0;
+        quint64 failures = 0;
+        quint64 slowExecutions = 0;
+        qint64 totalNs = 0;
+        qint64 maxNs = 0;
+        qint64 rowsAffected = 0;
+        qint64 uiStallNs = 0;      // Tiempo en el hilo de UI durante bloqueos
+        QList<quint64> histogram;  // Un contador por límite de bucketBoundsMs()
+        QSet<QString> callers;
+    };
+
+    static QueryProfiler& instance();
+
+    /**
+     * @brief Límites superiores (ms) de los buckets del histograma
+     */
+    static const QList<double>& bucketBoundsMs();
+
+    /**
+     * @brief Registrar una ejecución ya medida
+     * @param rows Filas afectadas (escrituras), leídas (SELECT de una
+     *             sentencia de la caché) o -1 si no se conoce
+     */
+    void record(const QSqlDatabase& db, const QSqlQuery& query, const char* caller,
+                qint64 elapsedNs, bool success, int rows);
+
+    /**
+     * @brief Umbral a partir del cual una consulta se considera lenta (0: todas)
+     */
+    int slowThresholdMs() const;
+    void setSlowThresholdMs(int thresholdMs);
+
+    /**
+     * @brief Leer el umbral desde settings (clave slow_query_threshold_ms)
+     */
+    void loadSettings(const QSqlDatabase& db);
+
+    /**
+     * @brief Ruta del log de consultas lentas
+     */
+    QString slowLogPath() const;
+
+    /**
+     * @brief Estadísticas por sentencia en formato JSON
+     */
+    QJsonObject toJson() const;
+
+    /**
+     * @brief Escribir toJson() en un archivo
+     */
+    bool dumpJson(const QString& filePath) const;
+
+    /**
+     * @brief Reiniciar los contadores
+     */
+    void reset();
+
+signals:
+    /**
+     * @brief Emitida (desde el hilo que ejecutó la consulta) al detectar una consulta lenta
+     */
+    void slowQueryDetected(const QString& sql, double elapsedMs, const QString& caller);
+
+    /**
+     * @brief Emitida (en el hilo de UI) al terminar un bloqueo del hilo de UI
+     * @param queryMs Parte del bloqueo que fueron consultas en ese hilo
+     */
+    void uiStallDetected(double stallMs, double queryMs);
+
+private:
+    explicit QueryProfiler(QObject *parent = nullptr);
+
+    QueryProfiler(const QueryProfiler&) = delete;
+    QueryProfiler& operator=(const QueryProfiler&) = delete;
+
+    /**
+     * @brief Obtener el plan de ejecución con los mismos parámetros
+     */
+    QStringList explainQueryPlan(const QSqlDatabase& db, const QSqlQuery& query) const;
+
+    /**
+     * @brief Agregar una entrada al log, rotando si supera el tamaño máximo
+     */
+    void writeSlowLog(const QString& entry);
+
+    /**
+     * @brief Registrar un bloqueo de UI con las consultas de su ventana
+     */
+    void recordUiStall(double stallMs);
+
+    QHash<QString, StatementStats> m_stats;
+
+    // Consultas del hilo de UI desde el último latido (protegidas por m_mutex)
+    QHash<QString, qint64> m_uiWindowQueries;
+    quint64 m_uiWindowBeat = 0;
+    quint64 m_uiStalls = 0;
+    qint64 m_uiStallTotalNs = 0;
+    qint64 m_uiStallMaxNs = 0;
+    qint64 m_uiStallQueryNs = 0;
+    int m_slowThresholdMs = 100;
+    QString m_logPath;
+    mutable QMutex m_mutex;
+    mutable QMutex m_logMutex;
+};
+
+#endif // QUERYPROFILER_H
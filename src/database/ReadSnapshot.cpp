@@ -0,0 +1,18 @@
+#include "ReadSnapshot.h"
+#include "DatabaseManager.h"
+#include <QDebug>
+
+ReadSnapshot::ReadSnapshot()
+    : m_active(DatabaseManager::instance().beginReadSnapshot())
+{
+    if (!m_active) {
+        qWarning() << "Instantánea de lectura no disponible, usando la conexión normal";
+    }
+}
+
+ReadSnapshot::~ReadSnapshot()
+{
+    if (m_active) {
+        DatabaseManager::instance().endReadSnapshot();
+    }
+}
@@ -0,0 +1,42 @@
+#ifndef READSNAPSHOT_H
+#define READSNAPSHOT_H
+
+/**
+ * @brief Instantánea de lectura con alcance (RAII) en el hilo actual
+ *
+ * Mientras vive, las consultas hechas con DatabaseConnection en este hilo
+ * usan una conexión de solo lectura fijada a un mismo punto en el tiempo
+ * (ver DatabaseManager::beginReadSnapshot). Pensada para reportes y
+ * agregados largos: ven datos consistentes entre consultas y no retrasan
+ * el commit de una venta.
+ *
+ * Uso:
+ * @code
+ * ReadSnapshot snapshot;
+ * auto stats = repo.getStatsForDateRange(from, to);
+ * auto top = repo.getTopProducts(from, to, 5);  // Mismo punto en el tiempo
+ * @endcode
+ *
+ * Si la instantánea no se pudo abrir, las consultas usan la conexión normal.
+ * Lo mismo ocurre mientras el hilo tenga un TransactionScope abierto: sus
+ * escrituras (y las lecturas que deben verlas) van a la conexión normal.
+ */
+class ReadSnapshot
+{
+public:
+    ReadSnapshot();
+    ~ReadSnapshot();
+
+    ReadSnapshot(const ReadSnapshot&) = delete;
+    ReadSnapshot& operator=(const ReadSnapshot&) = delete;
+
+    /**
+     * @brief Verificar si la instantánea está abierta
+     */
+    bool isActive() const { return m_active; }
+
+private:
+    bool m_active;
+};
+
+#endif // READSNAPSHOT_H
@@ -0,0 +1,18 @@
+#include "RowMapper.h"
+#include <QSqlRecord>
+#include <QDebug>
+
+RowMapper::RowMapper(const QSqlQuery& query, std::initializer_list<const char*> columns)
+    : m_query(query)
+{
+    const QSqlRecord record = query.record();
+    m_indices.reserve(static_cast<int>(columns.size()));
+
+    for (const char* column : columns) {
+        const int index = record.indexOf(QLatin1String(column));
+        if (index < 0 && !record.isEmpty()) {
+            qWarning() << "RowMapper: la columna" << column << "no está en el resultado";
+        }
+        m_indices.append(index);
+    }
+}
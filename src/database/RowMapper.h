@@ -0,0 +1,71 @@
+#ifndef ROWMAPPER_H
+#define ROWMAPPER_H
+
+#include "../models/LazyDateTime.h"
+#include <QSqlQuery>
+#include <QVariant>
+#include <QString>
+#include <QDate>
+#include <QVarLengthArray>
+#include <initializer_list>
+
+/**
+ * @brief Lector de filas con las columnas resueltas una vez por resultado
+ *
+ * query.value("nombre") busca la columna por nombre en cada fila. RowMapper
+ * resuelve los índices con QSqlRecord::indexOf() al crearse (después de
+ * exec()) y luego lee por posición. Los campos se piden con el índice de la
+ * lista de columnas, normalmente un enum local del repositorio:
+ *
+ * @code
+ * enum { ColId, ColName, ColCreatedAt };
+ * RowMapper row(query, {"id", "name", "created_at"});
+ * while (query.next()) {
+ *     item.id = row.toInt(ColId);
+ *     item.name = row.toString(ColName);
+ *     item.createdAt = row.toDateTime(ColCreatedAt);  // Se convierte al usarla
+ * }
+ * @endcode
+ *
+ * Una columna que no está en el resultado devuelve el valor por defecto.
+ * Guarda una referencia a la consulta: no debe sobrevivirla.
+ */
+class RowMapper
+{
+public:
+    RowMapper(const QSqlQuery& query, std::initializer_list<const char*> columns);
+
+    /**
+     * @brief Posición de la columna en el resultado (-1 si no está)
+     */
+    int index(int field) const { return m_indices[field]; }
+    bool contains(int field) const { return m_indices[field] >= 0; }
+
+    QVariant value(int field) const
+    {
+        const int column = m_indices[field];
+        return column >= 0 ? m_query.value(column) : QVariant();
+    }
+
+    int toInt(int field) const { return value(field).toInt(); }
+    qint64 toLongLong(int field) const { return value(field).toLongLong(); }
+    double toDouble(int field) const { return value(field).toDouble(); }
+    bool toBool(int field) const { return value(field).toBool(); }
+    QString toString(int field) const { return value(field).toString(); }
+
+    /**
+     * @brief Columna DATE ("yyyy-MM-dd")
+     */
+    QDate toDate(int field) const { return QDate::fromString(toString(field), Qt::ISODate); }
+
+    /**
+     * @brief Columna de fecha/hora; el texto se convierte recién al usarlo
+     */
+    LazyDateTime toDateTime(int field) const { return LazyDateTime::fromSqlText(toString(field)); }
+
+private:
+    const QSqlQuery& m_query;
+    QVarLengthArray<int, 24> m_indices;
+};
+
+#endif // ROWMAPPER_H
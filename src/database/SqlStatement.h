@@ -0,0 +1,238 @@
+#ifndef SQLSTATEMENT_H
+#define SQLSTATEMENT_H
+
+#include <QSqlQuery>
+#include <QVariant>
+#include <QString>
+#include <QDate>
+#include <QtGlobal>
+#include <tuple>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <cstddef>
+
+/**
+ * @brief Columnas (tipadas) que devuelve una sentencia
+ */
+template <typename... Columns>
+struct SqlRow {};
+
+/**
+ * @brief Sentencia SQL con parámetros posicionales y columnas tipados
+ *
+ * Se declara como constante constexpr junto al repositorio que la usa. Al
+ * compilar se verifica que la cantidad de '?' coincida con los parámetros
+ * declarados y, en bind(), que los argumentos se conviertan a esos tipos
+ * sin pérdida (int -> qint64 sí, double -> int no). El enlace es por
+ * posición, sin buscar ":nombre" en cada llamada.
+ *
+ * Uso:
+ * @code
+ * constexpr SqlStatement<SqlRow<int, double>, QDate, QDate> kStats{
+ *     "SELECT COUNT(*), COALESCE(SUM(total), 0) FROM sales WHERE sale_day BETWEEN ? AND ?"};
+ *
+ * auto query = conn.prepare(kStats.sql());
+ * kStats.bind(*query, from, to);
+ * if (conn.exec(query, Q_FUNC_INFO) && query->next()) {
+ *     const auto [count, total] = kStats.read(*query);
+ * }
+ * @endcode
+ *
+ * Las sentencias que devuelven filas completas (SELECT p.*) declaran
+ * SqlRow<> y se leen con RowMapper. Los parámetros std::optional<T> se
+ * enlazan como NULL cuando están vacíos; QDate se enlaza como "yyyy-MM-dd".
+ */
+template <typename Row, typename... Params>
+class SqlStatement;
+
+/**
+ * @brief Sentencia sin columnas de resultado (INSERT, UPDATE, DELETE)
+ */
+template <typename... Params>
+using SqlCommand = SqlStatement<SqlRow<>, Params...>;
+
+namespace SqlDetail {
+
+// '?' fuera de literales '...' y de identificadores "..."
+constexpr int countPlaceholders(const char* sql)
+{
+    int count = 0;
+    char quote = 0;
+    for (const char* c = sql; *c; ++c) {
+        if (quote) {
+            if (*c == quote) {
+                quote = 0;
+            }
+        } else if (*c == '\'' || *c == '"') {
+            quote = *c;
+        } else if (*c == '?') {
+            ++count;
+        }
+    }
+    return count;
+}
+
+// No es constexpr: llamarla al evaluar una constante es un error de compilación
+inline void placeholderCountMismatch()
+{
+    Q_ASSERT_X(false, "SqlStatement", "la cantidad de '?' no coincide con los parámetros");
+}
+
+// Param{arg} solo compila si la conversión no pierde información
+template <typename Param, typename Arg, typename = void>
+struct IsBindable : std::false_type {};
+
+template <typename Param, typename Arg>
+struct IsBindable<Param, Arg, std::void_t<decltype(Param{std::declval<const Arg&>()})>>
+    : std::true_type {};
+
+template <typename T>
+QVariant toVariant(const T& value)
+{
+    return QVariant::fromValue(value);
+}
+
+inline QVariant toVariant(const QDate& value)
+{
+    return value.toString(Qt::ISODate);
+}
+
+template <typename T>
+QVariant toVariant(const std::optional<T>& value)
+{
+    return value ? toVariant(*value) : QVariant();
+}
+
+template <typename T>
+struct FromVariant {
+    static T convert(const QVariant& value) { return value.value<T>(); }
+};
+
+template <>
+struct FromVariant<QDate> {
+    static QDate convert(const QVariant& value)
+    {
+        return QDate::fromString(value.toString(), Qt::ISODate);
+    }
+};
+
+template <typename T>
+struct FromVariant<std::optional<T>> {
+    static std::optional<T> convert(const QVariant& value)
+    {
+        if (value.isNull()) {
+            return std::nullopt;
+        }
+        return FromVariant<T>::convert(value);
+    }
+};
+
+// Copiar un literal (sin su '\0') a partir de position
+template <std::size_t M, std::size_t N>
+constexpr void appendText(char (&buffer)[M], std::size_t& position, const char (&part)[N])
+{
+    for (std::size_t i = 0; i + 1 < N; ++i) {
+        buffer[position++] = part[i];
+    }
+}
+
+} // namespace SqlDetail
+
+template <typename... Columns, typename... Params>
+class SqlStatement<SqlRow<Columns...>, Params...>
+{
+public:
+    using Result = std::tuple<Columns...>;
+
+    constexpr explicit SqlStatement(const char* sql)
+        : m_sql(sql)
+    {
+        if (SqlDetail::countPlaceholders(sql) != static_cast<int>(sizeof...(Params))) {
+            SqlDetail::placeholderCountMismatch();
+        }
+    }
+
+    constexpr const char* sql() const { return m_sql; }
+
+    /**
+     * @brief Enlazar todos los parámetros, en orden
+     */
+    template <typename... Args>
+    void bind(QSqlQuery& query, const Args&... args) const
+    {
+        static_assert(sizeof...(Args) == sizeof...(Params),
+                      "SqlStatement::bind: cantidad de argumentos distinta a la de la sentencia");
+        static_assert((SqlDetail::IsBindable<Params, Args>::value && ...),
+                      "SqlStatement::bind: argumento no convertible (o con pérdida) al tipo del parámetro");
+
+        int position = 0;
+        (query.bindValue(position++, SqlDetail::toVariant(Params{args})), ...);
+    }
+
+    /**
+     * @brief Leer la fila actual como tupla de las columnas declaradas
+     */
+    Result read(const QSqlQuery& query) const
+    {
+        static_assert(sizeof...(Columns) > 0,
+                      "SqlStatement::read: la sentencia no declara columnas (usar RowMapper)");
+        return readColumns(query, std::index_sequence_for<Columns...>());
+    }
+
+private:
+    template <std::size_t... I>
+    static Result readColumns(const QSqlQuery& query, std::index_sequence<I...>)
+    {
+        return Result(SqlDetail::FromVariant<Columns>::convert(query.value(static_cast<int>(I)))...);
+    }
+
+    const char* m_sql;
+};
+
+/**
+ * @brief Texto SQL armado al compilar (ver sqlConcat)
+ */
+template <std::size_t N>
+struct SqlText {
+    char text[N] = {};
+
+    constexpr const char* data() const { return text; }
+};
+
+/**
+ * @brief Unir fragmentos constexpr en un solo texto SQL
+ *
+ * Para compartir una lista de columnas entre varias sentencias:
+ * @code
+ * constexpr char kColumns[] = "p.id, p.name ";
+ * constexpr auto kByIdSql = sqlConcat("SELECT ", kColumns, "FROM products p WHERE p.id = ?");
+ * constexpr SqlStatement<SqlRow<>, int> kById{kByIdSql.data()};
+ * @endcode
+ */
+template <std::size_t... N>
+constexpr SqlText<(N + ...) - sizeof...(N) + 1> sqlConcat(const char (&... parts)[N])
+{
+    SqlText<(N + ...) - sizeof...(N) + 1> result;
+    std::size_t position = 0;
+    (SqlDetail::appendText(result.text, position, parts), ...);
+    return result;
+}
+
+/**
+ * @brief NULL para textos vacíos (columnas UNIQUE opcionales como sku o barcode)
+ */
+inline std::optional<QString> nullIfEmpty(const QString& text)
+{
+    return text.isEmpty() ? std::nullopt : std::optional<QString>(text);
+}
+
+/**
+ * @brief NULL para IDs sin asignar (claves foráneas opcionales)
+ */
+inline std::optional<int> optionalId(int id)
+{
+    return id > 0 ? std::optional<int>(id) : std::nullopt;
+}
+
+#endif // SQLSTATEMENT_H
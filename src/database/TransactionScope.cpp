@@ -0,0 +1,42 @@
+#include "TransactionScope.h"
+#include "DatabaseManager.h"
+#include <QDebug>
+
+TransactionScope::TransactionScope()
+    : m_active(DatabaseManager::instance().beginTransaction())
+{
+}
+
+TransactionScope::~TransactionScope()
+{
+    if (m_active) {
+        rollback();
+    }
+}
+
+bool TransactionScope::commit()
+{
+    if (!m_active) {
+        return false;
+    }
+
+    if (!DatabaseManager::instance().commit()) {
+        rollback();
+        return false;
+    }
+
+    m_active = false;
+    return true;
+}
+
+void TransactionScope::rollback()
+{
+    if (!m_active) {
+        return;
+    }
+
+    m_active = false;
+    if (!DatabaseManager::instance().rollback()) {
+        qWarning() << "Error revirtiendo transacción";
+    }
+}
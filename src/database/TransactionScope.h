@@ -0,0 +1,52 @@
+#ifndef TRANSACTIONSCOPE_H
+#define TRANSACTIONSCOPE_H
+
+/**
+ * @brief Transacción con alcance (RAII) sobre la conexión del hilo actual
+ *
+ * Si no hay transacción abierta inicia una; si la hay crea un SAVEPOINT,
+ * de modo que los servicios pueden componerse: un servicio abre su propio
+ * alcance y, cuando lo llama otro que ya tiene uno, sus cambios quedan
+ * dentro de la transacción externa y pueden revertirse por separado.
+ *
+ * Al destruirse sin commit() revierte su nivel.
+ *
+ * Uso:
+ * @code
+ * TransactionScope transaction;
+ * if (!transaction.isActive()) { ... }
+ * if (!repo.update(...)) {
+ *     return false;  // Rollback automático
+ * }
+ * return transaction.commit();
+ * @endcode
+ */
+class TransactionScope
+{
+public:
+    TransactionScope();
+    ~TransactionScope();
+
+    TransactionScope(const TransactionScope&) = delete;
+    TransactionScope& operator=(const TransactionScope&) = delete;
+
+    /**
+     * @brief Verificar si el nivel se abrió y sigue pendiente
+     */
+    bool isActive() const { return m_active; }
+
+    /**
+     * @brief Confirmar el nivel; si falla, lo revierte
+     */
+    bool commit();
+
+    /**
+     * @brief Revertir el nivel (solo los cambios hechos dentro de él)
+     */
+    void rollback();
+
+private:
+    bool m_active;
+};
+
+#endif // TRANSACTIONSCOPE_H
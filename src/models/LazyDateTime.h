@@ -0,0 +1,80 @@
+#ifndef LAZYDATETIME_H
+#define LAZYDATETIME_H
+
+#include <QString>
+#include <QDateTime>
+#include <QDate>
+#include <QTime>
+
+/**
+ * @brief Fecha/hora leída de SQLite que se convierte recién al usarla
+ *
+ * Los listados cargan miles de filas cuya fecha casi nunca se muestra;
+ * guardar el texto tal como viene ("yyyy-MM-dd HH:mm:ss", el formato de
+ * datetime('now')) evita parsear en cada fila. La conversión se hace en
+ * cada acceso y no se guarda, así que la copia puede leerse desde
+ * cualquier hilo.
+ *
+ * Se usa como un QDateTime: acepta asignar uno y convierte implícitamente.
+ */
+class LazyDateTime
+{
+public:
+    LazyDateTime() = default;
+    LazyDateTime(const QDateTime& value) : m_value(value) {}
+
+    /**
+     * @brief Texto de una columna de fecha, sin convertir
+     */
+    static LazyDateTime fromSqlText(const QString& text)
+    {
+        LazyDateTime result;
+        result.m_text = text;
+        return result;
+    }
+
+    QDateTime toDateTime() const
+    {
+        return m_text.isEmpty() ? m_value : parse(m_text);
+    }
+
+    operator QDateTime() const { return toDateTime(); }
+
+    QString toString(const QString& format) const { return toDateTime().toString(format); }
+    bool isNull() const { return m_text.isEmpty() && m_value.isNull(); }
+    bool isValid() const { return toDateTime().isValid(); }
+
+private:
+    static int digits(const QString& text, int from, int count)
+    {
+        int value = 0;
+        for (int i = from; i < from + count; ++i) {
+            const int digit = text.at(i).unicode() - '0';
+            if (digit < 0 || digit > 9) {
+                return -1;
+            }
+            value = value * 10 + digit;
+        }
+        return value;
+    }
+
+    static QDateTime parse(const QString& text)
+    {
+        // Camino rápido para "yyyy-MM-dd HH:mm:ss" (o con 'T'); el resto, ISO de Qt
+        if (text.size() == 19 && text.at(4) == '-' && text.at(7) == '-'
+            && (text.at(10) == ' ' || text.at(10) == 'T')
+            && text.at(13) == ':' && text.at(16) == ':') {
+            const QDate date(digits(text, 0, 4), digits(text, 5, 2), digits(text, 8, 2));
+            const QTime time(digits(text, 11, 2), digits(text, 14, 2), digits(text, 17, 2));
+            if (date.isValid() && time.isValid()) {
+                return QDateTime(date, time);
+            }
+        }
+        return QDateTime::fromString(text, Qt::ISODate);
+    }
+
+    QString m_text;     // Texto de SQLite pendiente de convertir
+    QDateTime m_value;  // Valor asignado desde código
+};
+
+#endif // LAZYDATETIME_H
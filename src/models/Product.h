@@ -1,8 +1,8 @@
 #ifndef PRODUCT_H
 #define PRODUCT_H
 
+#include "LazyDateTime.h"
 #include <QString>
-#include <QDateTime>
 
 /**
  * @brief Modelo de dominio para Producto
@@ -25,8 +25,8 @@ struct Product
     QString description;
     QString imagePath;
     bool active = true;
-    QDateTime createdAt;
-    QDateTime updatedAt;
+    LazyDateTime createdAt;
+    LazyDateTime updatedAt;
 
     /**
      * @brief Validar si el producto es válido
@@ -0,0 +1,34 @@
+#ifndef PRODUCTSUMMARY_H
+#define PRODUCTSUMMARY_H
+
+#include <QString>
+
+/**
+ * @brief Proyección liviana de Producto para listados
+ *
+ * Solo las columnas que muestran las listas (sin descripción, imagen
+ * ni fechas). El diálogo de edición carga el Product completo.
+ */
+struct ProductSummary
+{
+    int id = 0;
+    QString name;
+    QString sku;
+    QString barcode;
+    int categoryId = 0;
+    QString categoryName;
+    double currentStock = 0.0;
+    double minimumStock = 0.0;
+    double purchasePrice = 0.0;
+    double salePrice = 0.0;
+    bool active = true;
+
+    /**
+     * @brief Verificar si el stock está bajo
+     */
+    bool isLowStock() const {
+        return currentStock <= minimumStock;
+    }
+};
+
+#endif // PRODUCTSUMMARY_H
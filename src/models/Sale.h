@@ -1,8 +1,8 @@
 #ifndef SALE_H
 #define SALE_H
 
+#include "LazyDateTime.h"
 #include <QString>
-#include <QDateTime>
 #include <QList>
 
 /**
@@ -40,10 +40,12 @@ struct Sale
     QString paymentMethodName;  // Para joins
     QString status = "COMPLETED";  // COMPLETED, CANCELLED, PENDING
     QString notes;
-    QDateTime createdAt;
+    QString invoiceSeries = "BOLETA";  // BOLETA, FACTURA (numeración propia de cada serie)
+    LazyDateTime createdAt;
     QString createdBy;
 
     QList<SaleItem> items;  // Items de la venta
+    int itemCountHint = -1;  // Cantidad de items cuando se consultó solo el conteo
 
     /**
      * @brief Calcular totales de la venta
@@ -61,7 +63,7 @@ struct Sale
     }
 
     int itemCount() const {
-        return items.size();
+        return items.isEmpty() && itemCountHint >= 0 ? itemCountHint : items.size();
     }
 
     double totalQuantity() const {
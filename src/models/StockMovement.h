@@ -1,8 +1,8 @@
 #ifndef STOCKMOVEMENT_H
 #define STOCKMOVEMENT_H
 
+#include "LazyDateTime.h"
 #include <QString>
-#include <QDateTime>
 
 /**
  * @brief Modelo para movimientos de stock (Kardex)
@@ -20,7 +20,7 @@ struct StockMovement
     double unitPrice = 0.0;
     QString reference;  // Nº de factura, orden, etc.
     QString notes;
-    QDateTime createdAt;
+    LazyDateTime createdAt;
     QString createdBy;
 
     bool isValid() const {
@@ -1,109 +1,452 @@
 #include "ProductRepository.h"
-#include "../database/DatabaseManager.h"
+#include "../database/DatabaseConnection.h"
+#include "../database/DatabaseWorker.h"
+#include "../database/TransactionScope.h"
+#include "../database/RowMapper.h"
+#include "../database/SqlStatement.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QVariant>
+#include <QRegularExpression>
+#include <QSet>
 #include <QDebug>
+#include <utility>
+
+namespace {
+// 11 parámetros por fila: 80 filas quedan bajo el límite clásico de 999 variables
+constexpr int kUpsertBatchRows = 80;
+
+// Columnas que lee mapFromQuery, en el orden de productRow()
+enum ProductColumn {
+    ProductId, ProductName, ProductSku, ProductBarcode, ProductCategoryId,
+    ProductCategoryName, ProductCurrentStock, ProductMinimumStock,
+    ProductPurchasePrice, ProductSalePrice, ProductDescription,
+    ProductImagePath, ProductActive, ProductCreatedAt, ProductUpdatedAt
+};
+
+// Sentencias fijas del repositorio (parámetros verificados al compilar)
+constexpr SqlCommand<QString, std::optional<QString>, std::optional<QString>, std::optional<int>,
+                     double, double, double, double, QString, QString, bool> kInsertProduct{
+    "INSERT INTO products (name, sku, barcode, category_id, current_stock, "
+    "minimum_stock, purchase_price, sale_price, description, image_path, active) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"
+};
+
+constexpr SqlCommand<QString, std::optional<QString>, std::optional<QString>, std::optional<int>,
+                     double, double, double, double, QString, QString, bool, int> kUpdateProduct{
+    "UPDATE products SET name = ?, sku = ?, barcode = ?, "
+    "category_id = ?, current_stock = ?, minimum_stock = ?, "
+    "purchase_price = ?, sale_price = ?, "
+    "description = ?, image_path = ?, active = ?, "
+    "updated_at = datetime('now') WHERE id = ?"
+};
+
+constexpr SqlCommand<int> kDeactivateProduct{
+    "UPDATE products SET active = 0 WHERE id = ?"
+};
+
+constexpr SqlCommand<double, int> kUpdateStock{
+    "UPDATE products SET current_stock = ? WHERE id = ?"
+};
+
+constexpr SqlStatement<SqlRow<>, int> kFindById{
+    "SELECT p.*, c.name as category_name "
+    "FROM products p "
+    "LEFT JOIN categories c ON p.category_id = c.id "
+    "WHERE p.id = ?"
+};
+
+constexpr SqlStatement<SqlRow<>, QString> kFindBySku{
+    "SELECT p.*, c.name as category_name "
+    "FROM products p "
+    "LEFT JOIN categories c ON p.category_id = c.id "
+    "WHERE p.sku = ?"
+};
+
+constexpr SqlStatement<SqlRow<>, QString> kFindByBarcode{
+    "SELECT p.*, c.name as category_name "
+    "FROM products p "
+    "LEFT JOIN categories c ON p.category_id = c.id "
+    "WHERE p.barcode = ?"
+};
+
+constexpr SqlStatement<SqlRow<>, QString> kSearchByName{
+    "SELECT p.*, c.name as category_name "
+    "FROM products p "
+    "LEFT JOIN categories c ON p.category_id = c.id "
+    "WHERE p.active = 1 AND p.name LIKE ? "
+    "ORDER BY p.name"
+};
+
+constexpr SqlStatement<SqlRow<>, QString, int> kSearch{
+    // bm25 se calcula para todas las coincidencias activas antes de cortar:
+    // acotar los candidatos antes de ordenar perdería los más relevantes
+    "SELECT p.*, c.name as category_name "
+    "FROM products_fts f "
+    "JOIN products p ON p.id = f.rowid "
+    "LEFT JOIN categories c ON p.category_id = c.id "
+    "WHERE products_fts MATCH ? AND p.active = 1 "
+    "ORDER BY bm25(products_fts, 10.0, 8.0, 8.0, 1.0, 2.0) "
+    "LIMIT ?"
+};
+
+constexpr SqlStatement<SqlRow<>, int> kFindByCategory{
+    "SELECT p.*, c.name as category_name "
+    "FROM products p "
+    "LEFT JOIN categories c ON p.category_id = c.id "
+    "WHERE p.category_id = ? AND p.active = 1 "
+    "ORDER BY p.name"
+};
+
+// Columnas de ProductSummary, en el orden que lee mapSummaryFromQuery
+constexpr char kSummaryColumns[] =
+    "p.id, p.name, p.sku, p.barcode, p.category_id, c.name, "
+    "p.current_stock, p.minimum_stock, p.purchase_price, p.sale_price, p.active ";
+
+constexpr auto kSummariesByCategorySql = sqlConcat(
+    "SELECT ", kSummaryColumns,
+    "FROM products p "
+    "LEFT JOIN categories c ON p.category_id = c.id "
+    "WHERE p.category_id = ? AND p.active = 1 "
+    "ORDER BY p.name");
+constexpr SqlStatement<SqlRow<>, int> kSummariesByCategory{kSummariesByCategorySql.data()};
+
+// Mismo criterio que kSearch
+constexpr auto kSearchSummariesSql = sqlConcat(
+    "SELECT ", kSummaryColumns,
+    "FROM products_fts f "
+    "JOIN products p ON p.id = f.rowid "
+    "LEFT JOIN categories c ON p.category_id = c.id "
+    "WHERE products_fts MATCH ? AND p.active = 1 "
+    "ORDER BY bm25(products_fts, 10.0, 8.0, 8.0, 1.0, 2.0) "
+    "LIMIT ?");
+constexpr SqlStatement<SqlRow<>, QString, int> kSearchSummaries{kSearchSummariesSql.data()};
+
+constexpr auto kChangesSinceSql = sqlConcat(
+    "SELECT ch.product_id, p.id IS NULL, ", kSummaryColumns,
+    "FROM (SELECT DISTINCT product_id FROM product_changes "
+    "      WHERE version > ? AND version <= ?) ch "
+    "LEFT JOIN products p ON p.id = ch.product_id "
+    "LEFT JOIN categories c ON p.category_id = c.id");
+constexpr SqlStatement<SqlRow<>, qint64, qint64> kChangesSince{kChangesSinceSql.data()};
+
+constexpr SqlStatement<SqlRow<qint64>> kCurrentChangeVersion{
+    "SELECT COALESCE(MAX(version), 0) FROM product_changes"
+};
+
+// Solo recorre idx_products_low_stock (migración 6)
+constexpr SqlStatement<SqlRow<int>> kCountLowStock{
+    "SELECT COUNT(*) FROM products WHERE low_stock = 1"
+};
+
+constexpr SqlStatement<SqlRow<int>> kCountActive{
+    "SELECT COUNT(*) FROM products WHERE active = 1"
+};
+}
 
 int ProductRepository::create(Product& product)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    
-    query.prepare(
-        "INSERT INTO products (name, sku, barcode, category_id, current_stock, "
-        "minimum_stock, purchase_price, sale_price, description, image_path, active) "
-        "VALUES (:name, :sku, :barcode, :category_id, :current_stock, "
-        ":minimum_stock, :purchase_price, :sale_price, :description, :image_path, :active)"
-    );
+    DatabaseConnection conn;
+    auto query = conn.prepare(kInsertProduct.sql());
+    kInsertProduct.bind(*query, product.name, nullIfEmpty(product.sku), nullIfEmpty(product.barcode),
+                        optionalId(product.categoryId), product.currentStock, product.minimumStock,
+                        product.purchasePrice, product.salePrice, product.description,
+                        product.imagePath, product.active);
 
-    query.bindValue(":name", product.name);
-    query.bindValue(":sku", product.sku.isEmpty() ? QVariant() : product.sku);
-    query.bindValue(":barcode", product.barcode.isEmpty() ? QVariant() : product.barcode);
-    query.bindValue(":category_id", product.categoryId > 0 ? product.categoryId : QVariant());
-    query.bindValue(":current_stock", product.currentStock);
-    query.bindValue(":minimum_stock", product.minimumStock);
-    query.bindValue(":purchase_price", product.purchasePrice);
-    query.bindValue(":sale_price", product.salePrice);
-    query.bindValue(":description", product.description);
-    query.bindValue(":image_path", product.imagePath);
-    query.bindValue(":active", product.active);
-
-    if (!query.exec()) {
-        qCritical() << "Error creando producto:" << query.lastError().text();
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error creando producto:" << query->lastError().text();
         return 0;
     }
 
-    int newId = query.lastInsertId().toInt();
+    int newId = query->lastInsertId().toInt();
     product.id = newId;
     return newId;
 }
 
-bool ProductRepository::update(const Product& product)
+QList<ProductRepository::UpsertOutcome> ProductRepository::upsertMany(QList<Product>& products)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    
+    QList<UpsertOutcome> outcomes(products.size());
+    if (products.isEmpty()) {
+        return outcomes;
+    }
+
+    TransactionScope transaction;
+    if (!transaction.isActive()) {
+        for (UpsertOutcome& outcome : outcomes) {
+            outcome.errorMessage = "Error iniciando transacción";
+        }
+        return outcomes;
+    }
+
+    // Estado guardado de los SKU ya vistos (de la base o de lotes anteriores)
+    QHash<QString, Product> known;
+    QHash<QString, int> insertedRow;  // SKU nuevo -> fila, para leer su ID
+
+    int start = 0;
+    while (start < products.size()) {
+        // Lote: hasta kUpsertBatchRows filas y sin SKU repetido (un mismo
+        // INSERT ... ON CONFLICT no puede modificar dos veces la misma fila)
+        QList<int> batch;
+        QSet<QString> batchSkus;
+        int next = start;
+        for (; next < products.size() && batch.size() < kUpsertBatchRows; ++next) {
+            const QString& sku = products.at(next).sku;
+            if (sku.isEmpty()) {
+                outcomes[next].errorMessage = "El SKU es obligatorio";
+                continue;
+            }
+            if (batchSkus.contains(sku)) {
+                break;
+            }
+            batchSkus.insert(sku);
+            batch.append(next);
+        }
+        start = next;
+
+        QStringList lookup;
+        for (const QString& sku : std::as_const(batchSkus)) {
+            if (!known.contains(sku)) {
+                lookup.append(sku);
+            }
+        }
+        if (!lookup.isEmpty()) {
+            known.insert(findBySkus(lookup));
+        }
+
+        // Clasificar y descartar lo que no cambia
+        QList<int> writes;
+        for (int row : std::as_const(batch)) {
+            Product& product = products[row];
+            UpsertOutcome& outcome = outcomes[row];
+
+            auto existing = known.constFind(product.sku);
+            if (existing == known.constEnd()) {
+                outcome.status = UpsertOutcome::Inserted;
+                writes.append(row);
+                continue;
+            }
+
+            product.id = existing->id;
+            outcome.id = existing->id;
+            outcome.previousStock = existing->currentStock;
+
+            const bool unchanged = existing->name == product.name
+                && existing->barcode == product.barcode
+                && existing->categoryId == product.categoryId
+                && qFuzzyCompare(1.0 + existing->currentStock, 1.0 + product.currentStock)
+                && qFuzzyCompare(1.0 + existing->minimumStock, 1.0 + product.minimumStock)
+                && qFuzzyCompare(1.0 + existing->purchasePrice, 1.0 + product.purchasePrice)
+                && qFuzzyCompare(1.0 + existing->salePrice, 1.0 + product.salePrice)
+                && existing->description == product.description
+                && existing->imagePath == product.imagePath
+                && existing->active == product.active;
+
+            outcome.status = unchanged ? UpsertOutcome::Unchanged : UpsertOutcome::Updated;
+            if (!unchanged) {
+                writes.append(row);
+            }
+        }
+
+        if (writes.isEmpty()) {
+            continue;
+        }
+
+        QString errorMessage;
+        if (!writeUpsertBatch(products, writes, errorMessage)) {
+            // El INSERT fallido no dejó cambios: aislar las filas con error
+            qWarning() << "Lote de" << writes.size() << "productos rechazado, reintentando por fila:"
+                       << errorMessage;
+            QList<int> saved;
+            for (int row : std::as_const(writes)) {
+                if (writeUpsertBatch(products, {row}, errorMessage)) {
+                    saved.append(row);
+                } else {
+                    outcomes[row].status = UpsertOutcome::Failed;
+                    outcomes[row].id = 0;
+                    outcomes[row].errorMessage = errorMessage;
+                }
+            }
+            writes = saved;
+        }
+
+        for (int row : std::as_const(writes)) {
+            const Product& product = products.at(row);
+            if (outcomes.at(row).status == UpsertOutcome::Inserted) {
+                insertedRow.insert(product.sku, row);
+            }
+            known.insert(product.sku, product);
+        }
+
+        // IDs de los productos nuevos del lote
+        QStringList insertedSkus;
+        for (int row : std::as_const(writes)) {
+            if (outcomes.at(row).status == UpsertOutcome::Inserted) {
+                insertedSkus.append(products.at(row).sku);
+            }
+        }
+        if (!insertedSkus.isEmpty()) {
+            const QHash<QString, Product> created = findBySkus(insertedSkus);
+            for (auto it = created.constBegin(); it != created.constEnd(); ++it) {
+                const int row = insertedRow.value(it.key());
+                products[row].id = it->id;
+                outcomes[row].id = it->id;
+                known[it.key()].id = it->id;
+            }
+        }
+    }
+
+    if (!transaction.commit()) {
+        for (UpsertOutcome& outcome : outcomes) {
+            outcome.status = UpsertOutcome::Failed;
+            outcome.errorMessage = "Error confirmando la transacción";
+        }
+    }
+
+    return outcomes;
+}
+
+bool ProductRepository::writeUpsertBatch(const QList<Product>& products, const QList<int>& rows,
+                                         QString& errorMessage)
+{
+    constexpr int kColumns = 11;
+
+    QString sql =
+        "INSERT INTO products (name, sku, barcode, category_id, current_stock, "
+        "minimum_stock, purchase_price, sale_price, description, image_path, active) VALUES ";
+    for (int i = 0; i < rows.size(); ++i) {
+        sql += i == 0 ? "(?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)" : ", (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+    }
+    sql +=
+        " ON CONFLICT(sku) DO UPDATE SET "
+        "name = excluded.name, barcode = excluded.barcode, category_id = excluded.category_id, "
+        "current_stock = excluded.current_stock, minimum_stock = excluded.minimum_stock, "
+        "purchase_price = excluded.purchase_price, sale_price = excluded.sale_price, "
+        "description = excluded.description, image_path = excluded.image_path, "
+        "active = excluded.active, updated_at = datetime('now')";
+
+    // Los lotes completos comparten el texto SQL y reutilizan la sentencia
+    DatabaseConnection conn;
+    auto query = conn.prepare(sql);
+
+    int position = 0;
+    for (int row : rows) {
+        const Product& product = products.at(row);
+        query->bindValue(position++, product.name);
+        query->bindValue(position++, product.sku);
+        query->bindValue(position++, product.barcode.isEmpty() ? QVariant() : product.barcode);
+        query->bindValue(position++, product.categoryId > 0 ? product.categoryId : QVariant());
+        query->bindValue(position++, product.currentStock);
+        query->bindValue(position++, product.minimumStock);
+        query->bindValue(position++, product.purchasePrice);
+        query->bindValue(position++, product.salePrice);
+        query->bindValue(position++, product.description);
+        query->bindValue(position++, product.imagePath);
+        query->bindValue(position++, product.active);
+    }
+    Q_ASSERT(position == rows.size() * kColumns);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        errorMessage = query->lastError().text();
+        return false;
+    }
+
+    return true;
+}
+
+QHash<QString, Product> ProductRepository::findBySkus(const QStringList& skus)
+{
+    QHash<QString, Product> products;
+    if (skus.isEmpty()) {
+        return products;
+    }
+
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
+    query.setForwardOnly(true);
+
+    QString placeholders = "?";
+    for (int i = 1; i < skus.size(); ++i) {
+        placeholders += ", ?";
+    }
     query.prepare(
-        "UPDATE products SET name = :name, sku = :sku, barcode = :barcode, "
-        "category_id = :category_id, current_stock = :current_stock, minimum_stock = :minimum_stock, "
-        "purchase_price = :purchase_price, sale_price = :sale_price, "
-        "description = :description, image_path = :image_path, active = :active, "
-        "updated_at = datetime('now') WHERE id = :id"
+        "SELECT id, name, sku, barcode, category_id, current_stock, minimum_stock, "
+        "purchase_price, sale_price, description, image_path, active "
+        "FROM products WHERE sku IN (" + placeholders + ")"
     );
+    for (int i = 0; i < skus.size(); ++i) {
+        query.bindValue(i, skus.at(i));
+    }
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error buscando productos por SKU:" << query.lastError().text();
+        return products;
+    }
 
-    query.bindValue(":id", product.id);
-    query.bindValue(":name", product.name);
-    query.bindValue(":sku", product.sku.isEmpty() ? QVariant() : product.sku);
-    query.bindValue(":barcode", product.barcode.isEmpty() ? QVariant() : product.barcode);
-    query.bindValue(":category_id", product.categoryId > 0 ? product.categoryId : QVariant());
-    query.bindValue(":current_stock", product.currentStock);
-    query.bindValue(":minimum_stock", product.minimumStock);
-    query.bindValue(":purchase_price", product.purchasePrice);
-    query.bindValue(":sale_price", product.salePrice);
-    query.bindValue(":description", product.description);
-    query.bindValue(":image_path", product.imagePath);
-    query.bindValue(":active", product.active);
-
-    if (!query.exec()) {
-        qCritical() << "Error actualizando producto:" << query.lastError().text();
+    while (query.next()) {
+        Product product;
+        product.id = query.value(0).toInt();
+        product.name = query.value(1).toString();
+        product.sku = query.value(2).toString();
+        product.barcode = query.value(3).toString();
+        product.categoryId = query.value(4).toInt();
+        product.currentStock = query.value(5).toDouble();
+        product.minimumStock = query.value(6).toDouble();
+        product.purchasePrice = query.value(7).toDouble();
+        product.salePrice = query.value(8).toDouble();
+        product.description = query.value(9).toString();
+        product.imagePath = query.value(10).toString();
+        product.active = query.value(11).toBool();
+        products.insert(product.sku, product);
+    }
+
+    return products;
+}
+
+bool ProductRepository::update(const Product& product)
+{
+    DatabaseConnection conn;
+    auto query = conn.prepare(kUpdateProduct.sql());
+    kUpdateProduct.bind(*query, product.name, nullIfEmpty(product.sku), nullIfEmpty(product.barcode),
+                        optionalId(product.categoryId), product.currentStock, product.minimumStock,
+                        product.purchasePrice, product.salePrice, product.description,
+                        product.imagePath, product.active, product.id);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error actualizando producto:" << query->lastError().text();
         return false;
     }
 
-    return query.numRowsAffected() > 0;
+    return query->numRowsAffected() > 0;
 }
 
 bool ProductRepository::remove(int id)
 {
     // Soft delete: marcar como inactivo
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare("UPDATE products SET active = 0 WHERE id = :id");
-    query.bindValue(":id", id);
-    
-    if (!query.exec()) {
-        qCritical() << "Error eliminando producto:" << query.lastError().text();
+    DatabaseConnection conn;
+    auto query = conn.prepare(kDeactivateProduct.sql());
+    kDeactivateProduct.bind(*query, id);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error eliminando producto:" << query->lastError().text();
         return false;
     }
 
-    return query.numRowsAffected() > 0;
+    return query->numRowsAffected() > 0;
 }
 
 std::optional<Product> ProductRepository::findById(int id)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(
-        "SELECT p.*, c.name as category_name "
-        "FROM products p "
-        "LEFT JOIN categories c ON p.category_id = c.id "
-        "WHERE p.id = :id"
-    );
-    query.bindValue(":id", id);
+    DatabaseConnection conn;
+    auto query = conn.prepare(kFindById.sql());
+    kFindById.bind(*query, id);
 
-    if (!query.exec()) {
-        qCritical() << "Error buscando producto por ID:" << query.lastError().text();
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error buscando producto por ID:" << query->lastError().text();
         return std::nullopt;
     }
 
-    if (query.next()) {
-        return mapFromQuery(query);
+    if (query->next()) {
+        return mapFromQuery(productRow(*query));
     }
 
     return std::nullopt;
@@ -111,22 +454,17 @@ std::optional<Product> ProductRepository::findById(int id)
 
 std::optional<Product> ProductRepository::findBySku(const QString& sku)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(
-        "SELECT p.*, c.name as category_name "
-        "FROM products p "
-        "LEFT JOIN categories c ON p.category_id = c.id "
-        "WHERE p.sku = :sku"
-    );
-    query.bindValue(":sku", sku);
+    DatabaseConnection conn;
+    auto query = conn.prepare(kFindBySku.sql());
+    kFindBySku.bind(*query, sku);
 
-    if (!query.exec()) {
-        qCritical() << "Error buscando producto por SKU:" << query.lastError().text();
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error buscando producto por SKU:" << query->lastError().text();
         return std::nullopt;
     }
 
-    if (query.next()) {
-        return mapFromQuery(query);
+    if (query->next()) {
+        return mapFromQuery(productRow(*query));
     }
 
     return std::nullopt;
@@ -134,22 +472,17 @@ std::optional<Product> ProductRepository::findBySku(const QString& sku)
 
 std::optional<Product> ProductRepository::findByBarcode(const QString& barcode)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(
-        "SELECT p.*, c.name as category_name "
-        "FROM products p "
-        "LEFT JOIN categories c ON p.category_id = c.id "
-        "WHERE p.barcode = :barcode"
-    );
-    query.bindValue(":barcode", barcode);
+    DatabaseConnection conn;
+    auto query = conn.prepare(kFindByBarcode.sql());
+    kFindByBarcode.bind(*query, barcode);
 
-    if (!query.exec()) {
-        qCritical() << "Error buscando producto por código de barras:" << query.lastError().text();
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error buscando producto por código de barras:" << query->lastError().text();
         return std::nullopt;
     }
 
-    if (query.next()) {
-        return mapFromQuery(query);
+    if (query->next()) {
+        return mapFromQuery(productRow(*query));
     }
 
     return std::nullopt;
@@ -158,7 +491,8 @@ std::optional<Product> ProductRepository::findByBarcode(const QString& barcode)
 QList<Product> ProductRepository::findAll(bool activeOnly)
 {
     QList<Product> products;
-    QSqlQuery query(DatabaseManager::instance().database());
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
     
     QString sql = 
         "SELECT p.*, c.name as category_name "
@@ -171,65 +505,259 @@ QList<Product> ProductRepository::findAll(bool activeOnly)
     
     sql += "ORDER BY p.name";
 
-    if (!query.exec(sql)) {
+    if (!conn.exec(query, sql, Q_FUNC_INFO)) {
         qCritical() << "Error obteniendo productos:" << query.lastError().text();
         return products;
     }
 
+    const RowMapper row = productRow(query);
     while (query.next()) {
-        products.append(mapFromQuery(query));
+        products.append(mapFromQuery(row));
     }
 
     return products;
 }
 
+QFuture<QList<Product>> ProductRepository::findAllAsync(bool activeOnly)
+{
+    return DatabaseWorker::instance().run([activeOnly]() {
+        return ProductRepository().findAll(activeOnly);
+    });
+}
+
+QList<ProductSummary> ProductRepository::findPage(const QString& afterName, int afterId, int limit,
+                                                  const PageFilters& filters)
+{
+    QList<ProductSummary> products;
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
+    query.setForwardOnly(true);
+
+    QString sql = summarySelect() + "WHERE 1 = 1 ";
+
+    if (filters.activeOnly) {
+        sql += "AND p.active = 1 ";
+    }
+    if (filters.categoryId > 0) {
+        sql += "AND p.category_id = :category_id ";
+    }
+    if (!filters.categoryName.isEmpty()) {
+        sql += "AND c.name = :category_name COLLATE NOCASE ";
+    }
+    if (afterId > 0) {
+        // Comparación de tuplas: continúa justo después del cursor
+        sql += "AND (p.name, p.id) > (:after_name, :after_id) ";
+    }
+
+    sql += "ORDER BY p.name, p.id LIMIT :limit";
+
+    query.prepare(sql);
+    if (filters.categoryId > 0) {
+        query.bindValue(":category_id", filters.categoryId);
+    }
+    if (!filters.categoryName.isEmpty()) {
+        query.bindValue(":category_name", filters.categoryName);
+    }
+    if (afterId > 0) {
+        query.bindValue(":after_name", afterName);
+        query.bindValue(":after_id", afterId);
+    }
+    query.bindValue(":limit", limit);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error obteniendo página de productos:" << query.lastError().text();
+        return products;
+    }
+
+    products.reserve(limit);
+    while (query.next()) {
+        products.append(mapSummaryFromQuery(query));
+    }
+
+    return products;
+}
+
+QFuture<QList<ProductSummary>> ProductRepository::findPageAsync(const QString& afterName, int afterId,
+                                                                int limit, const PageFilters& filters)
+{
+    return DatabaseWorker::instance().run([afterName, afterId, limit, filters]() {
+        return ProductRepository().findPage(afterName, afterId, limit, filters);
+    });
+}
+
 QList<Product> ProductRepository::searchByName(const QString& name)
 {
     QList<Product> products;
-    QSqlQuery query(DatabaseManager::instance().database());
-    
+    DatabaseConnection conn;
+    auto query = conn.prepare(kSearchByName.sql());
+    kSearchByName.bind(*query, "%" + name + "%");
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error buscando productos:" << query->lastError().text();
+        return products;
+    }
+
+    const RowMapper row = productRow(*query);
+    while (query->next()) {
+        products.append(mapFromQuery(row));
+    }
+
+    return products;
+}
+
+QFuture<QList<Product>> ProductRepository::searchByNameAsync(const QString& name)
+{
+    return DatabaseWorker::instance().run([name]() {
+        return ProductRepository().searchByName(name);
+    });
+}
+
+QList<Product> ProductRepository::search(const QString& text, int limit)
+{
+    QList<Product> products;
+
+    const QString match = buildMatchExpression(text);
+    if (match.isEmpty()) {
+        return products;
+    }
+
+    DatabaseConnection conn;
+    auto query = conn.prepare(kSearch.sql());
+    kSearch.bind(*query, match, limit);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error en búsqueda de productos:" << query->lastError().text();
+        return products;
+    }
+
+    const RowMapper row = productRow(*query);
+    while (query->next()) {
+        products.append(mapFromQuery(row));
+    }
+
+    return products;
+}
+
+QFuture<QList<Product>> ProductRepository::searchAsync(const QString& text, int limit)
+{
+    return DatabaseWorker::instance().run([text, limit]() {
+        return ProductRepository().search(text, limit);
+    });
+}
+
+QString ProductRepository::buildMatchExpression(const QString& text)
+{
+    QStringList terms;
+    const QStringList words = text.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+    for (QString word : words) {
+        // Entre comillas la palabra es literal; "" escapa una comilla
+        word.replace('"', "\"\"");
+        terms.append('"' + word + "\"*");
+    }
+    return terms.join(' ');
+}
+
+QList<Product> ProductRepository::findByIds(const QList<int>& ids)
+{
+    QList<Product> products;
+    if (ids.isEmpty()) {
+        return products;
+    }
+
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
+    query.setForwardOnly(true);
+
+    QStringList placeholders;
+    for (int i = 0; i < ids.size(); ++i) {
+        placeholders.append("?");
+    }
     query.prepare(
         "SELECT p.*, c.name as category_name "
         "FROM products p "
         "LEFT JOIN categories c ON p.category_id = c.id "
-        "WHERE p.active = 1 AND p.name LIKE :name "
-        "ORDER BY p.name"
+        "WHERE p.id IN (" + placeholders.join(", ") + ")"
     );
-    query.bindValue(":name", "%" + name + "%");
+    for (int i = 0; i < ids.size(); ++i) {
+        query.bindValue(i, ids.at(i));
+    }
 
-    if (!query.exec()) {
-        qCritical() << "Error buscando productos:" << query.lastError().text();
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error obteniendo productos por ID:" << query.lastError().text();
         return products;
     }
 
+    QHash<int, Product> byId;
+    const RowMapper row = productRow(query);
     while (query.next()) {
-        products.append(mapFromQuery(query));
+        Product product = mapFromQuery(row);
+        byId.insert(product.id, product);
     }
 
+    for (int id : ids) {
+        auto it = byId.constFind(id);
+        if (it != byId.constEnd()) {
+            products.append(*it);
+        }
+    }
+    return products;
+}
+
+QList<ProductSummary> ProductRepository::findSummariesByIds(const QList<int>& ids)
+{
+    QList<ProductSummary> products;
+    if (ids.isEmpty()) {
+        return products;
+    }
+
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
+    query.setForwardOnly(true);
+
+    QStringList placeholders;
+    for (int i = 0; i < ids.size(); ++i) {
+        placeholders.append("?");
+    }
+    query.prepare(summarySelect() + "WHERE p.id IN (" + placeholders.join(", ") + ")");
+    for (int i = 0; i < ids.size(); ++i) {
+        query.bindValue(i, ids.at(i));
+    }
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error obteniendo productos por ID:" << query.lastError().text();
+        return products;
+    }
+
+    QHash<int, ProductSummary> byId;
+    while (query.next()) {
+        ProductSummary product = mapSummaryFromQuery(query);
+        byId.insert(product.id, product);
+    }
+
+    for (int id : ids) {
+        auto it = byId.constFind(id);
+        if (it != byId.constEnd()) {
+            products.append(*it);
+        }
+    }
     return products;
 }
 
 QList<Product> ProductRepository::findByCategory(int categoryId)
 {
     QList<Product> products;
-    QSqlQuery query(DatabaseManager::instance().database());
-    
-    query.prepare(
-        "SELECT p.*, c.name as category_name "
-        "FROM products p "
-        "LEFT JOIN categories c ON p.category_id = c.id "
-        "WHERE p.category_id = :category_id AND p.active = 1 "
-        "ORDER BY p.name"
-    );
-    query.bindValue(":category_id", categoryId);
+    DatabaseConnection conn;
+    auto query = conn.prepare(kFindByCategory.sql());
+    kFindByCategory.bind(*query, categoryId);
 
-    if (!query.exec()) {
-        qCritical() << "Error obteniendo productos por categoría:" << query.lastError().text();
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error obteniendo productos por categoría:" << query->lastError().text();
         return products;
     }
 
-    while (query.next()) {
-        products.append(mapFromQuery(query));
+    const RowMapper row = productRow(*query);
+    while (query->next()) {
+        products.append(mapFromQuery(row));
     }
 
     return products;
@@ -238,72 +766,282 @@ QList<Product> ProductRepository::findByCategory(int categoryId)
 QList<Product> ProductRepository::findLowStock()
 {
     QList<Product> products;
-    QSqlQuery query(DatabaseManager::instance().database());
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
     
-    if (!query.exec(
+    if (!conn.exec(query,
         "SELECT p.*, c.name as category_name "
         "FROM products p "
         "LEFT JOIN categories c ON p.category_id = c.id "
-        "WHERE p.current_stock <= p.minimum_stock AND p.active = 1 "
-        "ORDER BY p.current_stock ASC"
+        "WHERE p.low_stock = 1 "
+        "ORDER BY p.current_stock ASC",
+        Q_FUNC_INFO
+    )) {
+        qCritical() << "Error obteniendo productos con stock bajo:" << query.lastError().text();
+        return products;
+    }
+
+    const RowMapper row = productRow(query);
+    while (query.next()) {
+        products.append(mapFromQuery(row));
+    }
+
+    return products;
+}
+
+QList<ProductSummary> ProductRepository::findAllSummaries(bool activeOnly)
+{
+    QList<ProductSummary> products;
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
+    query.setForwardOnly(true);
+
+    QString sql = summarySelect();
+    if (activeOnly) {
+        sql += "WHERE p.active = 1 ";
+    }
+    sql += "ORDER BY p.name";
+
+    if (!conn.exec(query, sql, Q_FUNC_INFO)) {
+        qCritical() << "Error obteniendo productos:" << query.lastError().text();
+        return products;
+    }
+
+    while (query.next()) {
+        products.append(mapSummaryFromQuery(query));
+    }
+
+    return products;
+}
+
+QList<ProductSummary> ProductRepository::findSummariesByCategory(int categoryId)
+{
+    QList<ProductSummary> products;
+    DatabaseConnection conn;
+    auto query = conn.prepare(kSummariesByCategory.sql());
+    kSummariesByCategory.bind(*query, categoryId);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error obteniendo productos por categoría:" << query->lastError().text();
+        return products;
+    }
+
+    while (query->next()) {
+        products.append(mapSummaryFromQuery(*query));
+    }
+
+    return products;
+}
+
+QList<ProductSummary> ProductRepository::findLowStockSummaries()
+{
+    QList<ProductSummary> products;
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
+    query.setForwardOnly(true);
+
+    if (!conn.exec(query,
+        summarySelect() +
+        "WHERE p.low_stock = 1 "
+        "ORDER BY p.current_stock ASC",
+        Q_FUNC_INFO
     )) {
         qCritical() << "Error obteniendo productos con stock bajo:" << query.lastError().text();
         return products;
     }
 
     while (query.next()) {
-        products.append(mapFromQuery(query));
+        products.append(mapSummaryFromQuery(query));
     }
 
     return products;
 }
 
+QList<ProductSummary> ProductRepository::searchSummaries(const QString& text, int limit)
+{
+    QList<ProductSummary> products;
+
+    const QString match = buildMatchExpression(text);
+    if (match.isEmpty()) {
+        return products;
+    }
+
+    DatabaseConnection conn;
+    auto query = conn.prepare(kSearchSummaries.sql());
+    kSearchSummaries.bind(*query, match, limit);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error en búsqueda de productos:" << query->lastError().text();
+        return products;
+    }
+
+    while (query->next()) {
+        products.append(mapSummaryFromQuery(*query));
+    }
+
+    return products;
+}
+
+QFuture<QList<ProductSummary>> ProductRepository::searchSummariesAsync(const QString& text, int limit)
+{
+    return DatabaseWorker::instance().run([text, limit]() {
+        return ProductRepository().searchSummaries(text, limit);
+    });
+}
+
+qint64 ProductRepository::currentChangeVersion()
+{
+    DatabaseConnection conn;
+    auto query = conn.prepare(kCurrentChangeVersion.sql());
+
+    if (!conn.exec(query, Q_FUNC_INFO) || !query->next()) {
+        qCritical() << "Error obteniendo versión de cambios:" << query->lastError().text();
+        return 0;
+    }
+
+    return std::get<0>(kCurrentChangeVersion.read(*query));
+}
+
+ProductRepository::ChangeSet ProductRepository::changesSince(qint64 version)
+{
+    ChangeSet changes;
+    changes.version = version;
+
+    // Cota superior fija: lo que se confirme mientras tanto queda para la próxima vez
+    const qint64 upTo = currentChangeVersion();
+    if (upTo <= version) {
+        return changes;
+    }
+
+    DatabaseConnection conn;
+    auto query = conn.prepare(kChangesSince.sql());
+    kChangesSince.bind(*query, version, upTo);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error obteniendo cambios de productos:" << query->lastError().text();
+        return changes;
+    }
+
+    while (query->next()) {
+        if (query->value(1).toBool()) {
+            changes.deleted.append(query->value(0).toInt());
+        } else {
+            // Las columnas desde la 2 siguen el orden de kSummaryColumns
+            changes.changed.append(mapSummaryFromQuery(*query, 2));
+        }
+    }
+
+    changes.version = upTo;
+    return changes;
+}
+
+QFuture<ProductRepository::ChangeSet> ProductRepository::changesSinceAsync(qint64 version)
+{
+    return DatabaseWorker::instance().run([version]() {
+        return ProductRepository().changesSince(version);
+    });
+}
+
 bool ProductRepository::updateStock(int productId, double newStock)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare("UPDATE products SET current_stock = :stock WHERE id = :id");
-    query.bindValue(":stock", newStock);
-    query.bindValue(":id", productId);
-    
-    if (!query.exec()) {
-        qCritical() << "Error actualizando stock:" << query.lastError().text();
+    DatabaseConnection conn;
+    auto query = conn.prepare(kUpdateStock.sql());
+    kUpdateStock.bind(*query, newStock, productId);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error actualizando stock:" << query->lastError().text();
         return false;
     }
 
-    return query.numRowsAffected() > 0;
+    return query->numRowsAffected() > 0;
+}
+
+int ProductRepository::countLowStock()
+{
+    DatabaseConnection conn;
+    auto query = conn.prepare(kCountLowStock.sql());
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error contando productos con stock bajo:" << query->lastError().text();
+        return 0;
+    }
+
+    if (query->next()) {
+        return std::get<0>(kCountLowStock.read(*query));
+    }
+
+    return 0;
 }
 
 int ProductRepository::count()
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    if (!query.exec("SELECT COUNT(*) FROM products WHERE active = 1")) {
+    DatabaseConnection conn;
+    auto query = conn.prepare(kCountActive.sql());
+    if (!conn.exec(query, Q_FUNC_INFO)) {
         return 0;
     }
 
-    if (query.next()) {
-        return query.value(0).toInt();
+    if (query->next()) {
+        return std::get<0>(kCountActive.read(*query));
     }
 
     return 0;
 }
 
-Product ProductRepository::mapFromQuery(const QSqlQuery& query)
+RowMapper ProductRepository::productRow(const QSqlQuery& query)
+{
+    // Mismo orden que ProductColumn
+    return RowMapper(query, {
+        "id", "name", "sku", "barcode", "category_id", "category_name",
+        "current_stock", "minimum_stock", "purchase_price", "sale_price",
+        "description", "image_path", "active", "created_at", "updated_at"
+    });
+}
+
+Product ProductRepository::mapFromQuery(const RowMapper& row)
 {
     Product product;
-    product.id = query.value("id").toInt();
-    product.name = query.value("name").toString();
-    product.sku = query.value("sku").toString();
-    product.barcode = query.value("barcode").toString();
-    product.categoryId = query.value("category_id").toInt();
-    product.categoryName = query.value("category_name").toString();
-    product.currentStock = query.value("current_stock").toDouble();
-    product.minimumStock = query.value("minimum_stock").toDouble();
-    product.purchasePrice = query.value("purchase_price").toDouble();
-    product.salePrice = query.value("sale_price").toDouble();
-    product.description = query.value("description").toString();
-    product.imagePath = query.value("image_path").toString();
-    product.active = query.value("active").toBool();
-    product.createdAt = QDateTime::fromString(query.value("created_at").toString(), Qt::ISODate);
-    product.updatedAt = QDateTime::fromString(query.value("updated_at").toString(), Qt::ISODate);
+    product.id = row.toInt(ProductId);
+    product.name = row.toString(ProductName);
+    product.sku = row.toString(ProductSku);
+    product.barcode = row.toString(ProductBarcode);
+    product.categoryId = row.toInt(ProductCategoryId);
+    product.categoryName = row.toString(ProductCategoryName);
+    product.currentStock = row.toDouble(ProductCurrentStock);
+    product.minimumStock = row.toDouble(ProductMinimumStock);
+    product.purchasePrice = row.toDouble(ProductPurchasePrice);
+    product.salePrice = row.toDouble(ProductSalePrice);
+    product.description = row.toString(ProductDescription);
+    product.imagePath = row.toString(ProductImagePath);
+    product.active = row.toBool(ProductActive);
+    product.createdAt = row.toDateTime(ProductCreatedAt);
+    product.updatedAt = row.toDateTime(ProductUpdatedAt);
+    return product;
+}
+
+QString ProductRepository::summarySelect()
+{
+    return QStringLiteral("SELECT ") + QLatin1String(kSummaryColumns) +
+           QStringLiteral("FROM products p LEFT JOIN categories c ON p.category_id = c.id ");
+}
+
+ProductSummary ProductRepository::mapSummaryFromQuery(const QSqlQuery& query, int offset)
+{
+    enum Column {
+        Id, Name, Sku, Barcode, CategoryId, CategoryName,
+        CurrentStock, MinimumStock, PurchasePrice, SalePrice, Active
+    };
+
+    ProductSummary product;
+    product.id = query.value(offset + Id).toInt();
+    product.name = query.value(offset + Name).toString();
+    product.sku = query.value(offset + Sku).toString();
+    product.barcode = query.value(offset + Barcode).toString();
+    product.categoryId = query.value(offset + CategoryId).toInt();
+    product.categoryName = query.value(offset + CategoryName).toString();
+    product.currentStock = query.value(offset + CurrentStock).toDouble();
+    product.minimumStock = query.value(offset + MinimumStock).toDouble();
+    product.purchasePrice = query.value(offset + PurchasePrice).toDouble();
+    product.salePrice = query.value(offset + SalePrice).toDouble();
+    product.active = query.value(offset + Active).toBool();
     return product;
 }
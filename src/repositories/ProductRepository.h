@@ -2,10 +2,17 @@
 #define PRODUCTREPOSITORY_H
 
 #include "../models/Product.h"
+#include "../models/ProductSummary.h"
 #include <QList>
 #include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QFuture>
 #include <optional>
 
+class RowMapper;
+class QSqlQuery;
+
 /**
  * @brief Repositorio para acceso a datos de Productos
  * 
@@ -18,12 +25,57 @@ class ProductRepository
 public:
     ProductRepository() = default;
 
+    /**
+     * @brief Filtros del listado paginado
+     */
+    struct PageFilters {
+        bool activeOnly = true;
+        int categoryId = 0;        // 0: todas
+        QString categoryName;      // Vacío: todas (sin distinguir mayúsculas)
+    };
+
+    /**
+     * @brief Resultado de upsertMany() para una fila
+     */
+    struct UpsertOutcome {
+        enum Status { Inserted, Updated, Unchanged, Failed };
+        Status status = Failed;
+        int id = 0;                // ID del producto (nuevo o existente)
+        double previousStock = 0;  // Stock antes de la operación (0 si es nuevo)
+        QString errorMessage;
+    };
+
+    /**
+     * @brief Cambios de productos desde una versión (ver changesSince)
+     */
+    struct ChangeSet {
+        qint64 version = 0;              // Versión hasta la que se sincronizó
+        QList<ProductSummary> changed;   // Estado actual (incluye desactivados)
+        QList<int> deleted;              // Borrados físicamente
+    };
+
     /**
      * @brief Crear un nuevo producto
      * @return ID del producto creado, o 0 si falla
      */
     int create(Product& product);
 
+    /**
+     * @brief Insertar o actualizar muchos productos identificados por SKU
+     *
+     * Agrupa las filas en INSERT ... ON CONFLICT(sku) DO UPDATE de varias
+     * filas, dentro de una transacción (un savepoint si ya hay una). Las
+     * filas idénticas a lo guardado no se escriben (Unchanged). Si un lote
+     * falla (p. ej. código de barras repetido) se reintenta fila por fila
+     * para aislar las que fallan.
+     *
+     * Asigna product.id en las filas guardadas. categoryId debe venir
+     * resuelto; categoryName se ignora.
+     *
+     * @return Un resultado por producto, en el mismo orden
+     */
+    QList<UpsertOutcome> upsertMany(QList<Product>& products);
+
     /**
      * @brief Actualizar producto existente
      */
@@ -54,11 +106,75 @@ public:
      */
     QList<Product> findAll(bool activeOnly = true);
 
+    /**
+     * @brief Versión asíncrona de findAll (se ejecuta en DatabaseWorker)
+     */
+    QFuture<QList<Product>> findAllAsync(bool activeOnly = true);
+
+    /**
+     * @brief Página de productos ordenada por (nombre, id)
+     *
+     * Paginación por cursor (keyset): la página siguiente empieza después
+     * del último producto recibido, así el costo depende del tamaño de la
+     * página y no de cuántas filas hay antes. Usa idx_products_active_name.
+     *
+     * @param afterName Nombre del último producto de la página anterior
+     * @param afterId ID del último producto de la página anterior (0: primera página)
+     */
+    QList<ProductSummary> findPage(const QString& afterName, int afterId, int limit,
+                                   const PageFilters& filters = PageFilters());
+
+    /**
+     * @brief Versión asíncrona de findPage (se ejecuta en DatabaseWorker)
+     */
+    QFuture<QList<ProductSummary>> findPageAsync(const QString& afterName, int afterId, int limit,
+                                                 const PageFilters& filters = PageFilters());
+
+    /**
+     * @brief Variantes de listado que devuelven ProductSummary
+     *
+     * Leen solo las columnas de la lista; usar estas en pantallas de
+     * listado y las que devuelven Product para editar un producto.
+     */
+    QList<ProductSummary> findAllSummaries(bool activeOnly = true);
+    QList<ProductSummary> findSummariesByCategory(int categoryId);
+    QList<ProductSummary> findLowStockSummaries();
+    QList<ProductSummary> searchSummaries(const QString& text, int limit = 50);
+    QFuture<QList<ProductSummary>> searchSummariesAsync(const QString& text, int limit = 50);
+
     /**
      * @brief Buscar productos por nombre (búsqueda parcial)
      */
     QList<Product> searchByName(const QString& name);
 
+    /**
+     * @brief Versión asíncrona de searchByName (se ejecuta en DatabaseWorker)
+     */
+    QFuture<QList<Product>> searchByNameAsync(const QString& name);
+
+    /**
+     * @brief Búsqueda de texto completo (FTS5) en nombre, SKU, código de
+     *        barras, descripción y categoría
+     *
+     * Cada palabra se busca como prefijo y sin distinguir tildes ("caf lech"
+     * encuentra "Café con Leche"); todas deben aparecer. Los resultados se
+     * ordenan por relevancia (bm25), pesando más el nombre y los códigos.
+     *
+     * @param limit Máximo de resultados
+     */
+    QList<Product> search(const QString& text, int limit = 50);
+
+    /**
+     * @brief Versión asíncrona de search (se ejecuta en DatabaseWorker)
+     */
+    QFuture<QList<Product>> searchAsync(const QString& text, int limit = 50);
+
+    /**
+     * @brief Cargar productos por ID, en el orden de ids (los que no existen se omiten)
+     */
+    QList<Product> findByIds(const QList<int>& ids);
+    QList<ProductSummary> findSummariesByIds(const QList<int>& ids);
+
     /**
      * @brief Obtener productos por categoría
      */
@@ -66,9 +182,39 @@ public:
 
     /**
      * @brief Obtener productos con stock bajo
+     *
+     * Usa el índice parcial idx_products_low_stock: el costo depende de
+     * cuántos productos tienen stock bajo, no del tamaño del catálogo.
      */
     QList<Product> findLowStock();
 
+    /**
+     * @brief Contar productos activos con stock bajo (sin cargarlos)
+     */
+    int countLowStock();
+
+    /**
+     * @brief Versión más reciente del registro product_changes
+     *
+     * Guardarla al cargar una vista y luego pedir changesSince() con ella.
+     */
+    qint64 currentChangeVersion();
+
+    /**
+     * @brief Productos modificados después de una versión
+     *
+     * Cada producto aparece una vez, con su estado actual, aunque haya
+     * cambiado varias veces. Aplicar el resultado es idempotente: un cambio
+     * posterior a la versión devuelta puede aparecer de nuevo en la
+     * próxima llamada.
+     */
+    ChangeSet changesSince(qint64 version);
+
+    /**
+     * @brief Versión asíncrona de changesSince (se ejecuta en DatabaseWorker)
+     */
+    QFuture<ChangeSet> changesSinceAsync(qint64 version);
+
     /**
      * @brief Actualizar stock de un producto
      * @param productId ID del producto
@@ -84,9 +230,50 @@ public:
 
 private:
     /**
-     * @brief Mapear un QSqlQuery a un objeto Product
+     * @brief Columnas de Product resueltas en el resultado de un SELECT p.*
+     *
+     * Crear una vez después de exec() y reutilizar en cada fila.
+     */
+    static RowMapper productRow(const QSqlQuery& query);
+
+    /**
+     * @brief Mapear la fila actual a un objeto Product
+     */
+    Product mapFromQuery(const RowMapper& row);
+
+    /**
+     * @brief Mapear una fila de summarySelect() a ProductSummary
+     *
+     * Lee por posición (sin buscar columnas por nombre en cada fila).
+     * @param offset Posición de la primera columna (p. ej. si hay columnas antes)
+     */
+    static ProductSummary mapSummaryFromQuery(const QSqlQuery& query, int offset = 0);
+
+    /**
+     * @brief SELECT ... FROM products p LEFT JOIN categories c con las
+     *        columnas de ProductSummary, en el orden de mapSummaryFromQuery
+     */
+    static QString summarySelect();
+
+    /**
+     * @brief Escribir un lote con un solo INSERT ... ON CONFLICT(sku)
+     * @param rows Índices en products
+     */
+    bool writeUpsertBatch(const QList<Product>& products, const QList<int>& rows,
+                          QString& errorMessage);
+
+    /**
+     * @brief Productos existentes (columnas editables) por SKU
+     */
+    QHash<QString, Product> findBySkus(const QStringList& skus);
+
+    /**
+     * @brief Convertir el texto del usuario en una expresión MATCH de FTS5
+     *
+     * Cada palabra se cita (los operadores de FTS5 no se interpretan) y
+     * se marca como prefijo. Devuelve vacío si no hay palabras.
      */
-    Product mapFromQuery(const class QSqlQuery& query);
+    static QString buildMatchExpression(const QString& text);
 };
 
 #endif // PRODUCTREPOSITORY_H
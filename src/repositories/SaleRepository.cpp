@@ -1,40 +1,201 @@
 #include "SaleRepository.h"
-#include "../database/DatabaseManager.h"
+#include "../database/DatabaseConnection.h"
+#include "../database/DatabaseWorker.h"
+#include "../database/RowMapper.h"
+#include "../database/SqlStatement.h"
+#include "../database/ReadSnapshot.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QSqlRecord>
 #include <QVariant>
+#include <QHash>
 #include <QDebug>
+#include <algorithm>
+
+namespace {
+// Columnas que lee mapFromQuery, en el orden de saleRow()
+enum SaleColumn {
+    SaleId, SaleInvoiceNumber, SaleCustomerId, SaleCustomerName, SaleSubtotal,
+    SaleTax, SaleDiscount, SaleTotal, SalePaymentMethodId, SalePaymentMethodName,
+    SaleStatus, SaleNotes, SaleCreatedAt, SaleCreatedBy
+};
+
+enum SaleItemColumn {
+    ItemId, ItemSaleId, ItemProductId, ItemProductName, ItemQuantity,
+    ItemUnitPrice, ItemSubtotal
+};
+
+// Sentencias fijas del repositorio (parámetros verificados al compilar)
+constexpr SqlCommand<QString, std::optional<int>, double, double, double, double,
+                     std::optional<int>, QString, QString, QString> kInsertSale{
+    "INSERT INTO sales (invoice_number, customer_id, subtotal, tax, discount, total, "
+    "payment_method_id, status, notes, created_by) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)"
+};
+
+// unit_cost: precio de compra vigente, para el costo en product_daily_sales
+constexpr SqlCommand<int, int, QString, double, double, double, int> kInsertSaleItem{
+    "INSERT INTO sale_items (sale_id, product_id, product_name, quantity, unit_price, subtotal, unit_cost) "
+    "VALUES (?, ?, ?, ?, ?, ?, (SELECT purchase_price FROM products WHERE id = ?))"
+};
+
+constexpr SqlCommand<int> kCancelSale{
+    "UPDATE sales SET status = 'CANCELLED' WHERE id = ?"
+};
+
+constexpr SqlStatement<SqlRow<>, int> kFindSaleById{
+    "SELECT s.*, c.name as customer_name, pm.name as payment_method_name "
+    "FROM sales s "
+    "LEFT JOIN customers c ON s.customer_id = c.id "
+    "LEFT JOIN payment_methods pm ON s.payment_method_id = pm.id "
+    "WHERE s.id = ?"
+};
+
+constexpr SqlStatement<SqlRow<>, QString> kFindSaleByInvoice{
+    "SELECT s.*, c.name as customer_name, pm.name as payment_method_name "
+    "FROM sales s "
+    "LEFT JOIN customers c ON s.customer_id = c.id "
+    "LEFT JOIN payment_methods pm ON s.payment_method_id = pm.id "
+    "WHERE s.invoice_number = ?"
+};
+
+constexpr SqlStatement<SqlRow<>, QDate, QDate> kSalesByDateRange{
+    "SELECT s.*, c.name as customer_name, pm.name as payment_method_name "
+    "FROM sales s "
+    "LEFT JOIN customers c ON s.customer_id = c.id "
+    "LEFT JOIN payment_methods pm ON s.payment_method_id = pm.id "
+    "WHERE s.sale_day BETWEEN ? AND ? "
+    "ORDER BY s.sale_day DESC, s.created_at DESC"
+};
+
+// Misma cabecera con la cantidad de items (subconsulta sobre idx_sale_items_sale)
+constexpr SqlStatement<SqlRow<>, QDate, QDate> kSalesWithItemCountsByDateRange{
+    "SELECT s.*, c.name as customer_name, pm.name as payment_method_name, "
+    "(SELECT COUNT(*) FROM sale_items si WHERE si.sale_id = s.id) as item_count "
+    "FROM sales s "
+    "LEFT JOIN customers c ON s.customer_id = c.id "
+    "LEFT JOIN payment_methods pm ON s.payment_method_id = pm.id "
+    "WHERE s.sale_day BETWEEN ? AND ? "
+    "ORDER BY s.sale_day DESC, s.created_at DESC"
+};
+
+// Items de todas las ventas del rango, en una sola consulta
+constexpr SqlStatement<SqlRow<>, QDate, QDate> kSaleItemsByDateRange{
+    "SELECT si.* FROM sales s "
+    "JOIN sale_items si ON si.sale_id = s.id "
+    "WHERE s.sale_day BETWEEN ? AND ? "
+    "ORDER BY si.sale_id, si.id"
+};
+
+// Recorridos (forEachInDateRange): mismo orden en cabeceras e items, servido
+// por idx_sales_day + rowid sin ordenar en memoria
+constexpr SqlStatement<SqlRow<>, QDate, QDate> kStreamSalesByDateRange{
+    "SELECT s.*, c.name as customer_name, pm.name as payment_method_name "
+    "FROM sales s "
+    "LEFT JOIN customers c ON s.customer_id = c.id "
+    "LEFT JOIN payment_methods pm ON s.payment_method_id = pm.id "
+    "WHERE s.sale_day BETWEEN ? AND ? "
+    "ORDER BY s.sale_day, s.created_at, s.id"
+};
+
+constexpr SqlStatement<SqlRow<>, QDate, QDate> kStreamSalesWithItemCountsByDateRange{
+    "SELECT s.*, c.name as customer_name, pm.name as payment_method_name, "
+    "(SELECT COUNT(*) FROM sale_items si WHERE si.sale_id = s.id) as item_count "
+    "FROM sales s "
+    "LEFT JOIN customers c ON s.customer_id = c.id "
+    "LEFT JOIN payment_methods pm ON s.payment_method_id = pm.id "
+    "WHERE s.sale_day BETWEEN ? AND ? "
+    "ORDER BY s.sale_day, s.created_at, s.id"
+};
+
+constexpr SqlStatement<SqlRow<>, QDate, QDate> kStreamSaleItemsByDateRange{
+    "SELECT si.* FROM sales s "
+    "JOIN sale_items si ON si.sale_id = s.id "
+    "WHERE s.sale_day BETWEEN ? AND ? "
+    "ORDER BY s.sale_day, s.created_at, s.id, si.id"
+};
+
+constexpr SqlStatement<SqlRow<>, int> kSaleItems{
+    "SELECT * FROM sale_items WHERE sale_id = ? ORDER BY id"
+};
+
+// Incremento atómico del contador del prefijo (lo crea en 1 si no existe)
+constexpr SqlCommand<QString, QString> kBumpInvoiceSequence{
+    "INSERT INTO invoice_sequences (prefix, series, last_number) VALUES (?, ?, 1) "
+    "ON CONFLICT(prefix) DO UPDATE SET last_number = last_number + 1"
+};
+
+constexpr SqlStatement<SqlRow<int>, QString> kInvoiceSequenceValue{
+    "SELECT last_number FROM invoice_sequences WHERE prefix = ?"
+};
+
+// Estadísticas desde sales_daily_summary (migración 9): una fila por día y método de pago
+constexpr SqlStatement<SqlRow<int, double>, QDate, QDate> kStatsForRange{
+    "SELECT COALESCE(SUM(sale_count), 0), COALESCE(SUM(net), 0) "
+    "FROM sales_daily_summary "
+    "WHERE day BETWEEN ? AND ?"
+};
+
+constexpr SqlStatement<SqlRow<QDate, int, double>, QDate, QDate> kDailySales{
+    "SELECT day, SUM(sale_count), SUM(net) "
+    "FROM sales_daily_summary "
+    "WHERE day BETWEEN ? AND ? "
+    "GROUP BY day "
+    "HAVING SUM(sale_count) > 0 "
+    "ORDER BY day ASC"
+};
+
+// Análisis por producto desde product_daily_sales (migración 10)
+constexpr SqlStatement<SqlRow<int, QString, double, double, double>, QDate, QDate, int> kTopProducts{
+    "SELECT d.product_id, COALESCE(p.name, ''), "
+    "SUM(d.quantity) as total_quantity, "
+    "SUM(d.revenue) as total_revenue, "
+    "SUM(d.cost) as total_cost "
+    "FROM product_daily_sales d "
+    "LEFT JOIN products p ON p.id = d.product_id "
+    "WHERE d.day BETWEEN ? AND ? "
+    "GROUP BY d.product_id "
+    "HAVING SUM(d.quantity) > 0 "
+    "ORDER BY total_revenue DESC "
+    "LIMIT ?"
+};
+
+constexpr SqlStatement<SqlRow<int, QString, double, double, double>, QDate> kSoldSince{
+    "SELECT p.id, p.name, p.current_stock, p.minimum_stock, v.quantity "
+    "FROM (SELECT product_id, SUM(quantity) AS quantity "
+    "      FROM product_daily_sales WHERE day >= ? "
+    "      GROUP BY product_id HAVING SUM(quantity) > 0) v "
+    "JOIN products p ON p.id = v.product_id "
+    "WHERE p.active = 1"
+};
+
+constexpr SqlStatement<SqlRow<int, QString, double, double, QDate>, QDate> kDeadStock{
+    "SELECT p.id, p.name, p.current_stock, p.current_stock * p.purchase_price AS stock_value, "
+    "       (SELECT MAX(d.day) FROM product_daily_sales d "
+    "        WHERE d.product_id = p.id AND d.quantity > 0) "
+    "FROM products p "
+    "WHERE p.active = 1 AND p.current_stock > 0 "
+    "AND NOT EXISTS (SELECT 1 FROM product_daily_sales d "
+    "                WHERE d.product_id = p.id AND d.day >= ? AND d.quantity > 0) "
+    "ORDER BY stock_value DESC"
+};
+}
 
 int SaleRepository::create(Sale& sale)
 {
-    auto& db = DatabaseManager::instance();
+    DatabaseConnection conn;
     
     // NO iniciar transacción aquí - la maneja SalesService
     // El servicio ya inició la transacción antes de llamar a este método
     
-    QSqlQuery query(db.database());
-    
     // Insertar venta principal
-    query.prepare(
-        "INSERT INTO sales (invoice_number, customer_id, subtotal, tax, discount, total, "
-        "payment_method_id, status, notes, created_by) "
-        "VALUES (:invoice_number, :customer_id, :subtotal, :tax, :discount, :total, "
-        ":payment_method_id, :status, :notes, :created_by)"
-    );
-
-    query.bindValue(":invoice_number", sale.invoiceNumber);
-    query.bindValue(":customer_id", sale.customerId > 0 ? sale.customerId : QVariant());
-    query.bindValue(":subtotal", sale.subtotal);
-    query.bindValue(":tax", sale.tax);
-    query.bindValue(":discount", sale.discount);
-    query.bindValue(":total", sale.total);
-    query.bindValue(":payment_method_id", sale.paymentMethodId > 0 ? sale.paymentMethodId : QVariant());
-    query.bindValue(":status", sale.status);
-    query.bindValue(":notes", sale.notes);
-    query.bindValue(":created_by", sale.createdBy);
-
-    if (!query.exec()) {
-        qCritical() << "Error creando venta:" << query.lastError().text();
+    auto query = conn.prepare(kInsertSale.sql());
+    kInsertSale.bind(*query, sale.invoiceNumber, optionalId(sale.customerId), sale.subtotal,
+                     sale.tax, sale.discount, sale.total, optionalId(sale.paymentMethodId),
+                     sale.status, sale.notes, sale.createdBy);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error creando venta:" << query->lastError().text();
         qCritical() << "  Invoice:" << sale.invoiceNumber;
         qCritical() << "  Customer ID:" << sale.customerId;
         qCritical() << "  Payment Method ID:" << sale.paymentMethodId;
@@ -42,33 +203,26 @@ int SaleRepository::create(Sale& sale)
         return 0;
     }
 
-    int saleId = query.lastInsertId().toInt();
+    int saleId = query->lastInsertId().toInt();
     sale.id = saleId;
     
     qDebug() << "  Sale inserted with ID:" << saleId;
 
     // Insertar items de venta
-    query.prepare(
-        "INSERT INTO sale_items (sale_id, product_id, product_name, quantity, unit_price, subtotal) "
-        "VALUES (:sale_id, :product_id, :product_name, :quantity, :unit_price, :subtotal)"
-    );
+    auto itemQuery = conn.prepare(kInsertSaleItem.sql());
 
     for (auto& item : sale.items) {
-        query.bindValue(":sale_id", saleId);
-        query.bindValue(":product_id", item.productId);
-        query.bindValue(":product_name", item.productName);
-        query.bindValue(":quantity", item.quantity);
-        query.bindValue(":unit_price", item.unitPrice);
-        query.bindValue(":subtotal", item.subtotal);
-
-        if (!query.exec()) {
-            qCritical() << "Error insertando item de venta:" << query.lastError().text();
+        kInsertSaleItem.bind(*itemQuery, saleId, item.productId, item.productName,
+                             item.quantity, item.unitPrice, item.subtotal, item.productId);
+
+        if (!conn.exec(itemQuery, Q_FUNC_INFO)) {
+            qCritical() << "Error insertando item de venta:" << itemQuery->lastError().text();
             qCritical() << "  Product:" << item.productName;
             qCritical() << "  Quantity:" << item.quantity;
             return 0;
         }
 
-        item.id = query.lastInsertId().toInt();
+        item.id = itemQuery->lastInsertId().toInt();
         item.saleId = saleId;
     }
     
@@ -80,23 +234,17 @@ int SaleRepository::create(Sale& sale)
 
 std::optional<Sale> SaleRepository::findById(int id)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(
-        "SELECT s.*, c.name as customer_name, pm.name as payment_method_name "
-        "FROM sales s "
-        "LEFT JOIN customers c ON s.customer_id = c.id "
-        "LEFT JOIN payment_methods pm ON s.payment_method_id = pm.id "
-        "WHERE s.id = :id"
-    );
-    query.bindValue(":id", id);
-
-    if (!query.exec()) {
-        qCritical() << "Error buscando venta:" << query.lastError().text();
+    DatabaseConnection conn;
+    auto query = conn.prepare(kFindSaleById.sql());
+    kFindSaleById.bind(*query, id);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error buscando venta:" << query->lastError().text();
         return std::nullopt;
     }
 
-    if (query.next()) {
-        Sale sale = mapFromQuery(query);
+    if (query->next()) {
+        Sale sale = mapFromQuery(saleRow(*query));
         sale.items = loadSaleItems(id);
         return sale;
     }
@@ -106,23 +254,17 @@ std::optional<Sale> SaleRepository::findById(int id)
 
 std::optional<Sale> SaleRepository::findByInvoiceNumber(const QString& invoiceNumber)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(
-        "SELECT s.*, c.name as customer_name, pm.name as payment_method_name "
-        "FROM sales s "
-        "LEFT JOIN customers c ON s.customer_id = c.id "
-        "LEFT JOIN payment_methods pm ON s.payment_method_id = pm.id "
-        "WHERE s.invoice_number = :invoice_number"
-    );
-    query.bindValue(":invoice_number", invoiceNumber);
-
-    if (!query.exec()) {
-        qCritical() << "Error buscando venta:" << query.lastError().text();
+    DatabaseConnection conn;
+    auto query = conn.prepare(kFindSaleByInvoice.sql());
+    kFindSaleByInvoice.bind(*query, invoiceNumber);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error buscando venta:" << query->lastError().text();
         return std::nullopt;
     }
 
-    if (query.next()) {
-        Sale sale = mapFromQuery(query);
+    if (query->next()) {
+        Sale sale = mapFromQuery(saleRow(*query));
         sale.items = loadSaleItems(sale.id);
         return sale;
     }
@@ -130,36 +272,145 @@ std::optional<Sale> SaleRepository::findByInvoiceNumber(const QString& invoiceNu
     return std::nullopt;
 }
 
-QList<Sale> SaleRepository::findByDateRange(const QDate& from, const QDate& to)
+QList<Sale> SaleRepository::findByDateRange(const QDate& from, const QDate& to, ItemLoading loading)
 {
     QList<Sale> sales;
-    QSqlQuery query(DatabaseManager::instance().database());
-    
-    query.prepare(
-        "SELECT s.*, c.name as customer_name, pm.name as payment_method_name "
-        "FROM sales s "
-        "LEFT JOIN customers c ON s.customer_id = c.id "
-        "LEFT JOIN payment_methods pm ON s.payment_method_id = pm.id "
-        "WHERE DATE(s.created_at) BETWEEN :from AND :to "
-        "ORDER BY s.created_at DESC"
-    );
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
-
-    if (!query.exec()) {
-        qCritical() << "Error obteniendo ventas:" << query.lastError().text();
+    DatabaseConnection conn;
+
+    const bool withCounts = loading == ItemLoading::CountsOnly;
+    auto query = conn.prepare(withCounts ? kSalesWithItemCountsByDateRange.sql()
+                                         : kSalesByDateRange.sql());
+    if (withCounts) {
+        kSalesWithItemCountsByDateRange.bind(*query, from, to);
+    } else {
+        kSalesByDateRange.bind(*query, from, to);
+    }
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error obteniendo ventas:" << query->lastError().text();
         return sales;
     }
 
-    while (query.next()) {
-        Sale sale = mapFromQuery(query);
-        sale.items = loadSaleItems(sale.id);
+    const RowMapper row = saleRow(*query);
+    const int itemCountColumn = withCounts ? query->record().indexOf("item_count") : -1;
+
+    QHash<int, int> indexById;
+    while (query->next()) {
+        Sale sale = mapFromQuery(row);
+        if (itemCountColumn >= 0) {
+            sale.itemCountHint = query->value(itemCountColumn).toInt();
+        }
+        indexById.insert(sale.id, sales.size());
         sales.append(sale);
     }
 
+    if (loading != ItemLoading::Full || sales.isEmpty()) {
+        return sales;
+    }
+
+    // Todos los items del rango de una vez, repartidos por sale_id
+    auto itemQuery = conn.prepare(kSaleItemsByDateRange.sql());
+    kSaleItemsByDateRange.bind(*itemQuery, from, to);
+
+    if (!conn.exec(itemQuery, Q_FUNC_INFO)) {
+        qCritical() << "Error cargando items de ventas:" << itemQuery->lastError().text();
+        return sales;
+    }
+
+    const RowMapper itemRow = saleItemRow(*itemQuery);
+    while (itemQuery->next()) {
+        SaleItem item = mapItemFromQuery(itemRow);
+        auto it = indexById.constFind(item.saleId);
+        if (it != indexById.constEnd()) {
+            sales[*it].items.append(item);
+        }
+    }
+
     return sales;
 }
 
+QFuture<QList<Sale>> SaleRepository::findByDateRangeAsync(const QDate& from, const QDate& to,
+                                                          ItemLoading loading)
+{
+    return DatabaseWorker::instance().run([from, to, loading]() {
+        return SaleRepository().findByDateRange(from, to, loading);
+    });
+}
+
+bool SaleRepository::forEachInDateRange(const QDate& from, const QDate& to,
+                                        const SaleVisitor& visitor, ItemLoading loading)
+{
+    DatabaseConnection conn;
+
+    const bool withCounts = loading == ItemLoading::CountsOnly;
+    auto query = conn.prepare(withCounts ? kStreamSalesWithItemCountsByDateRange.sql()
+                                         : kStreamSalesByDateRange.sql());
+    if (withCounts) {
+        kStreamSalesWithItemCountsByDateRange.bind(*query, from, to);
+    } else {
+        kStreamSalesByDateRange.bind(*query, from, to);
+    }
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error recorriendo ventas:" << query->lastError().text();
+        return false;
+    }
+
+    // Cursor de items solo con ItemLoading::Full. Ambos cursores comparten la
+    // transacción de lectura de la conexión, así que ven las mismas ventas
+    std::optional<CachedQuery> itemQuery;
+    std::optional<RowMapper> itemRow;
+    if (loading == ItemLoading::Full) {
+        itemQuery.emplace(conn.prepare(kStreamSaleItemsByDateRange.sql()));
+        kStreamSaleItemsByDateRange.bind(**itemQuery, from, to);
+        if (!conn.exec(itemQuery, Q_FUNC_INFO)) {
+            qCritical() << "Error recorriendo items de ventas:" << (*itemQuery)->lastError().text();
+            return false;
+        }
+        itemRow.emplace(saleItemRow(**itemQuery));
+    }
+
+    const RowMapper row = saleRow(*query);
+    const int itemCountColumn = withCounts ? query->record().indexOf("item_count") : -1;
+
+    SaleItem pendingItem;
+    bool hasPendingItem = itemQuery && (*itemQuery)->next();
+    if (hasPendingItem) {
+        pendingItem = mapItemFromQuery(*itemRow);
+    }
+
+    while (query->next()) {
+        Sale sale = mapFromQuery(row);
+        if (itemCountColumn >= 0) {
+            sale.itemCountHint = query->value(itemCountColumn).toInt();
+        }
+
+        // Los items de esta venta son los siguientes del cursor de items
+        while (hasPendingItem && pendingItem.saleId == sale.id) {
+            sale.items.append(pendingItem);
+            hasPendingItem = (*itemQuery)->next();
+            if (hasPendingItem) {
+                pendingItem = mapItemFromQuery(*itemRow);
+            }
+        }
+
+        if (!visitor(sale)) {
+            break;
+        }
+    }
+
+    return true;
+}
+
+QFuture<bool> SaleRepository::forEachInDateRangeAsync(const QDate& from, const QDate& to,
+                                                      SaleVisitor visitor, ItemLoading loading)
+{
+    return DatabaseWorker::readerInstance().run([from, to, visitor, loading]() {
+        ReadSnapshot snapshot;
+        return SaleRepository().forEachInDateRange(from, to, visitor, loading);
+    });
+}
+
 QList<Sale> SaleRepository::findToday()
 {
     QDate today = QDate::currentDate();
@@ -168,68 +419,46 @@ QList<Sale> SaleRepository::findToday()
 
 bool SaleRepository::cancel(int saleId)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare("UPDATE sales SET status = 'CANCELLED' WHERE id = :id");
-    query.bindValue(":id", saleId);
-    
-    if (!query.exec()) {
-        qCritical() << "Error cancelando venta:" << query.lastError().text();
+    DatabaseConnection conn;
+    auto query = conn.prepare(kCancelSale.sql());
+    kCancelSale.bind(*query, saleId);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error cancelando venta:" << query->lastError().text();
         return false;
     }
 
-    return query.numRowsAffected() > 0;
+    return query->numRowsAffected() > 0;
 }
 
-QString SaleRepository::generateNextInvoiceNumber()
+QString SaleRepository::allocateInvoiceNumber(const QString& series)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    
+    // Formato: YYYYMMDD-NNNN (boleta) y FYYYYMMDD-NNNN (factura)
     QString prefix = QDate::currentDate().toString("yyyyMMdd");
-    int sequence = 1;
-    QString invoiceNumber;
-    
-    // Intentar hasta encontrar un número único (máximo 100 intentos)
-    for (int attempt = 0; attempt < 100; ++attempt) {
-        // Obtener el último número de factura con este prefijo
-        query.prepare(
-            "SELECT invoice_number FROM sales "
-            "WHERE invoice_number LIKE :prefix "
-            "ORDER BY invoice_number DESC LIMIT 1"
-        );
-        query.bindValue(":prefix", prefix + "-%");
-
-        if (!query.exec()) {
-            qCritical() << "Error consultando números de factura:" << query.lastError().text();
-            break;
-        }
+    if (series == "FACTURA") {
+        prefix.prepend('F');
+    }
 
-        if (query.next()) {
-            QString lastInvoice = query.value(0).toString();
-            // Formato: YYYYMMDD-XXXX
-            QStringList parts = lastInvoice.split('-');
-            if (parts.size() == 2 && parts[0] == prefix) {
-                sequence = parts[1].toInt() + 1;
-            }
-        }
+    DatabaseConnection conn;
+    auto bump = conn.prepare(kBumpInvoiceSequence.sql());
+    kBumpInvoiceSequence.bind(*bump, prefix, series);
 
-        invoiceNumber = QString("%1-%2").arg(prefix).arg(sequence, 4, 10, QChar('0'));
-        
-        // Verificar que no exista ya (por si acaso)
-        query.prepare("SELECT COUNT(*) FROM sales WHERE invoice_number = :invoice");
-        query.bindValue(":invoice", invoiceNumber);
-        
-        if (query.exec() && query.next() && query.value(0).toInt() == 0) {
-            // Número único encontrado
-            qDebug() << "Generated unique invoice number:" << invoiceNumber;
-            return invoiceNumber;
-        }
-        
-        // Si ya existe, incrementar y reintentar
-        sequence++;
+    if (!conn.exec(bump, Q_FUNC_INFO)) {
+        qCritical() << "Error incrementando secuencia de comprobantes:" << bump->lastError().text();
+        return QString();
     }
-    
-    qCritical() << "Could not generate unique invoice number after 100 attempts";
-    return invoiceNumber;
+
+    // Misma transacción: lee el valor que acaba de escribir
+    auto query = conn.prepare(kInvoiceSequenceValue.sql());
+    kInvoiceSequenceValue.bind(*query, prefix);
+
+    if (!conn.exec(query, Q_FUNC_INFO) || !query->next()) {
+        qCritical() << "Error leyendo secuencia de comprobantes:" << query->lastError().text();
+        return QString();
+    }
+
+    const int sequence = std::get<0>(kInvoiceSequenceValue.read(*query));
+    return QString("%1-%2").arg(prefix).arg(sequence, 4, 10, QChar('0'));
 }
 
 SaleRepository::SalesStats SaleRepository::getStatsForDate(const QDate& date)
@@ -240,19 +469,12 @@ SaleRepository::SalesStats SaleRepository::getStatsForDate(const QDate& date)
 SaleRepository::SalesStats SaleRepository::getStatsForDateRange(const QDate& from, const QDate& to)
 {
     SalesStats stats;
-    QSqlQuery query(DatabaseManager::instance().database());
-    
-    query.prepare(
-        "SELECT COUNT(*) as count, COALESCE(SUM(total), 0) as total "
-        "FROM sales "
-        "WHERE DATE(created_at) BETWEEN :from AND :to AND status = 'COMPLETED'"
-    );
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
-
-    if (query.exec() && query.next()) {
-        stats.totalTransactions = query.value("count").toInt();
-        stats.totalSales = query.value("total").toDouble();
+    DatabaseConnection conn;
+    auto query = conn.prepare(kStatsForRange.sql());
+    kStatsForRange.bind(*query, from, to);
+
+    if (conn.exec(query, Q_FUNC_INFO) && query->next()) {
+        std::tie(stats.totalTransactions, stats.totalSales) = kStatsForRange.read(*query);
         
         if (stats.totalTransactions > 0) {
             stats.averageTicket = stats.totalSales / stats.totalTransactions;
@@ -265,31 +487,18 @@ SaleRepository::SalesStats SaleRepository::getStatsForDateRange(const QDate& fro
 QList<SaleRepository::DailySales> SaleRepository::getDailySalesInRange(const QDate& from, const QDate& to)
 {
     QList<DailySales> dailySales;
-    QSqlQuery query(DatabaseManager::instance().database());
-    
-    query.prepare(
-        "SELECT DATE(created_at) as sale_date, "
-        "COUNT(*) as transaction_count, "
-        "SUM(total) as total_sales "
-        "FROM sales "
-        "WHERE DATE(created_at) BETWEEN :from AND :to "
-        "AND status != 'CANCELLED' "
-        "GROUP BY DATE(created_at) "
-        "ORDER BY sale_date ASC"
-    );
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
-
-    if (query.exec()) {
-        while (query.next()) {
+    DatabaseConnection conn;
+    auto query = conn.prepare(kDailySales.sql());
+    kDailySales.bind(*query, from, to);
+
+    if (conn.exec(query, Q_FUNC_INFO)) {
+        while (query->next()) {
             DailySales daily;
-            daily.date = QDate::fromString(query.value("sale_date").toString(), Qt::ISODate);
-            daily.transactionCount = query.value("transaction_count").toInt();
-            daily.totalSales = query.value("total_sales").toDouble();
+            std::tie(daily.date, daily.transactionCount, daily.totalSales) = kDailySales.read(*query);
             dailySales.append(daily);
         }
     } else {
-        qCritical() << "Error obteniendo ventas diarias:" << query.lastError().text();
+        qCritical() << "Error obteniendo ventas diarias:" << query->lastError().text();
     }
 
     return dailySales;
@@ -298,86 +507,153 @@ QList<SaleRepository::DailySales> SaleRepository::getDailySalesInRange(const QDa
 QList<SaleRepository::TopProduct> SaleRepository::getTopProducts(const QDate& from, const QDate& to, int limit)
 {
     QList<TopProduct> topProducts;
-    QSqlQuery query(DatabaseManager::instance().database());
-    
-    query.prepare(
-        "SELECT si.product_id, si.product_name, "
-        "SUM(si.quantity) as total_quantity, "
-        "SUM(si.subtotal) as total_revenue "
-        "FROM sale_items si "
-        "INNER JOIN sales s ON si.sale_id = s.id "
-        "WHERE DATE(s.created_at) BETWEEN :from AND :to "
-        "AND s.status != 'CANCELLED' "
-        "GROUP BY si.product_id, si.product_name "
-        "ORDER BY total_revenue DESC "
-        "LIMIT :limit"
-    );
-    query.bindValue(":from", from.toString(Qt::ISODate));
-    query.bindValue(":to", to.toString(Qt::ISODate));
-    query.bindValue(":limit", limit);
-
-    if (query.exec()) {
-        while (query.next()) {
+    DatabaseConnection conn;
+    auto query = conn.prepare(kTopProducts.sql());
+    kTopProducts.bind(*query, from, to, limit);
+
+    if (conn.exec(query, Q_FUNC_INFO)) {
+        while (query->next()) {
             TopProduct product;
-            product.productId = query.value("product_id").toInt();
-            product.productName = query.value("product_name").toString();
-            product.quantitySold = query.value("total_quantity").toDouble();
-            product.totalRevenue = query.value("total_revenue").toDouble();
+            std::tie(product.productId, product.productName, product.quantitySold,
+                     product.totalRevenue, product.totalCost) = kTopProducts.read(*query);
             topProducts.append(product);
         }
     } else {
-        qCritical() << "Error obteniendo productos más vendidos:" << query.lastError().text();
+        qCritical() << "Error obteniendo productos más vendidos:" << query->lastError().text();
     }
 
     return topProducts;
 }
 
-Sale SaleRepository::mapFromQuery(const QSqlQuery& query)
+QList<SaleRepository::ReorderSuggestion> SaleRepository::getReorderSuggestions(int windowDays, int coverDays)
+{
+    QList<ReorderSuggestion> suggestions;
+    if (windowDays <= 0) {
+        return suggestions;
+    }
+
+    DatabaseConnection conn;
+    auto query = conn.prepare(kSoldSince.sql());
+    kSoldSince.bind(*query, QDate::currentDate().addDays(1 - windowDays));
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error calculando reposición:" << query->lastError().text();
+        return suggestions;
+    }
+
+    while (query->next()) {
+        ReorderSuggestion suggestion;
+        double soldInWindow = 0.0;
+        std::tie(suggestion.productId, suggestion.productName, suggestion.currentStock,
+                 suggestion.minimumStock, soldInWindow) = kSoldSince.read(*query);
+
+        suggestion.dailyVelocity = soldInWindow / windowDays;
+        const double target = suggestion.dailyVelocity * coverDays + suggestion.minimumStock;
+        if (suggestion.currentStock >= target) {
+            continue;
+        }
+
+        suggestion.daysOfCover = qMax(0.0, suggestion.currentStock) / suggestion.dailyVelocity;
+        suggestion.suggestedQuantity = target - suggestion.currentStock;
+        suggestions.append(suggestion);
+    }
+
+    std::sort(suggestions.begin(), suggestions.end(),
+              [](const ReorderSuggestion& a, const ReorderSuggestion& b) {
+                  return a.daysOfCover < b.daysOfCover;
+              });
+    return suggestions;
+}
+
+QList<SaleRepository::DeadStockProduct> SaleRepository::getDeadStock(int days)
+{
+    QList<DeadStockProduct> products;
+    DatabaseConnection conn;
+    auto query = conn.prepare(kDeadStock.sql());
+    kDeadStock.bind(*query, QDate::currentDate().addDays(1 - days));
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error obteniendo productos sin movimiento:" << query->lastError().text();
+        return products;
+    }
+
+    while (query->next()) {
+        DeadStockProduct product;
+        std::tie(product.productId, product.productName, product.currentStock,
+                 product.stockValue, product.lastSaleDate) = kDeadStock.read(*query);
+        products.append(product);
+    }
+
+    return products;
+}
+
+RowMapper SaleRepository::saleRow(const QSqlQuery& query)
+{
+    // Mismo orden que SaleColumn
+    return RowMapper(query, {
+        "id", "invoice_number", "customer_id", "customer_name", "subtotal",
+        "tax", "discount", "total", "payment_method_id", "payment_method_name",
+        "status", "notes", "created_at", "created_by"
+    });
+}
+
+Sale SaleRepository::mapFromQuery(const RowMapper& row)
 {
     Sale sale;
-    sale.id = query.value("id").toInt();
-    sale.invoiceNumber = query.value("invoice_number").toString();
-    sale.customerId = query.value("customer_id").toInt();
-    sale.customerName = query.value("customer_name").toString();
-    sale.subtotal = query.value("subtotal").toDouble();
-    sale.tax = query.value("tax").toDouble();
-    sale.discount = query.value("discount").toDouble();
-    sale.total = query.value("total").toDouble();
-    sale.paymentMethodId = query.value("payment_method_id").toInt();
-    sale.paymentMethodName = query.value("payment_method_name").toString();
-    sale.status = query.value("status").toString();
-    sale.notes = query.value("notes").toString();
-    sale.createdAt = QDateTime::fromString(query.value("created_at").toString(), Qt::ISODate);
-    sale.createdBy = query.value("created_by").toString();
+    sale.id = row.toInt(SaleId);
+    sale.invoiceNumber = row.toString(SaleInvoiceNumber);
+    sale.customerId = row.toInt(SaleCustomerId);
+    sale.customerName = row.toString(SaleCustomerName);
+    sale.subtotal = row.toDouble(SaleSubtotal);
+    sale.tax = row.toDouble(SaleTax);
+    sale.discount = row.toDouble(SaleDiscount);
+    sale.total = row.toDouble(SaleTotal);
+    sale.paymentMethodId = row.toInt(SalePaymentMethodId);
+    sale.paymentMethodName = row.toString(SalePaymentMethodName);
+    sale.status = row.toString(SaleStatus);
+    sale.notes = row.toString(SaleNotes);
+    sale.createdAt = row.toDateTime(SaleCreatedAt);
+    sale.createdBy = row.toString(SaleCreatedBy);
     return sale;
 }
 
 QList<SaleItem> SaleRepository::loadSaleItems(int saleId)
 {
     QList<SaleItem> items;
-    QSqlQuery query(DatabaseManager::instance().database());
-    
-    query.prepare(
-        "SELECT * FROM sale_items WHERE sale_id = :sale_id ORDER BY id"
-    );
-    query.bindValue(":sale_id", saleId);
+    DatabaseConnection conn;
+    auto query = conn.prepare(kSaleItems.sql());
+    kSaleItems.bind(*query, saleId);
 
-    if (!query.exec()) {
-        qCritical() << "Error cargando items de venta:" << query.lastError().text();
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error cargando items de venta:" << query->lastError().text();
         return items;
     }
 
-    while (query.next()) {
-        SaleItem item;
-        item.id = query.value("id").toInt();
-        item.saleId = query.value("sale_id").toInt();
-        item.productId = query.value("product_id").toInt();
-        item.productName = query.value("product_name").toString();
-        item.quantity = query.value("quantity").toDouble();
-        item.unitPrice = query.value("unit_price").toDouble();
-        item.subtotal = query.value("subtotal").toDouble();
-        items.append(item);
+    const RowMapper row = saleItemRow(*query);
+    while (query->next()) {
+        items.append(mapItemFromQuery(row));
     }
 
     return items;
 }
+
+RowMapper SaleRepository::saleItemRow(const QSqlQuery& query)
+{
+    // Mismo orden que SaleItemColumn
+    return RowMapper(query, {
+        "id", "sale_id", "product_id", "product_name", "quantity", "unit_price", "subtotal"
+    });
+}
+
+SaleItem SaleRepository::mapItemFromQuery(const RowMapper& row)
+{
+    SaleItem item;
+    item.id = row.toInt(ItemId);
+    item.saleId = row.toInt(ItemSaleId);
+    item.productId = row.toInt(ItemProductId);
+    item.productName = row.toString(ItemProductName);
+    item.quantity = row.toDouble(ItemQuantity);
+    item.unitPrice = row.toDouble(ItemUnitPrice);
+    item.subtotal = row.toDouble(ItemSubtotal);
+    return item;
+}
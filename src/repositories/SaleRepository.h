@@ -4,8 +4,13 @@
 #include "../models/Sale.h"
 #include <QList>
 #include <QDate>
+#include <QFuture>
+#include <functional>
 #include <optional>
 
+class RowMapper;
+class QSqlQuery;
+
 /**
  * @brief Repositorio para gestión de ventas
  */
@@ -14,6 +19,20 @@ class SaleRepository
 public:
     SaleRepository() = default;
 
+    /**
+     * @brief Visitor de recorridos: recibe cada venta; devolver false lo detiene
+     */
+    using SaleVisitor = std::function<bool(const Sale&)>;
+
+    /**
+     * @brief Qué cargar de los items en las consultas de varias ventas
+     */
+    enum class ItemLoading {
+        Full,        // Items completos (una consulta para todo el rango)
+        CountsOnly,  // Solo Sale::itemCountHint, sin items
+        None         // Sin items: cargarlos luego con loadSaleItems()
+    };
+
     /**
      * @brief Crear nueva venta con sus items
      * @return ID de la venta creada, o 0 si falla
@@ -32,8 +51,41 @@ public:
 
     /**
      * @brief Obtener ventas por rango de fechas
+     *
+     * Dos consultas en total: cabeceras y, con ItemLoading::Full, todos los
+     * items del rango, que se reparten en memoria por sale_id.
+     */
+    QList<Sale> findByDateRange(const QDate& from, const QDate& to,
+                                ItemLoading loading = ItemLoading::Full);
+
+    /**
+     * @brief Versión asíncrona de findByDateRange (se ejecuta en DatabaseWorker)
      */
-    QList<Sale> findByDateRange(const QDate& from, const QDate& to);
+    QFuture<QList<Sale>> findByDateRangeAsync(const QDate& from, const QDate& to,
+                                              ItemLoading loading = ItemLoading::Full);
+
+    /**
+     * @brief Recorrer las ventas de un rango sin cargarlas todas en memoria
+     *
+     * Cursores de solo avance sobre las cabeceras y, con ItemLoading::Full,
+     * sobre los items en el mismo orden: cada venta se arma, se entrega al
+     * visitor y se descarta. Para exportaciones, auditorías y conciliaciones
+     * de rangos largos (ver ChunkedDelivery para repartir en hilos).
+     *
+     * Orden cronológico (sale_day, created_at, id), el del índice idx_sales_day.
+     * @return false si falla la consulta; detenerse desde el visitor no es error
+     */
+    bool forEachInDateRange(const QDate& from, const QDate& to, const SaleVisitor& visitor,
+                            ItemLoading loading = ItemLoading::Full);
+
+    /**
+     * @brief Versión asíncrona de forEachInDateRange
+     *
+     * Se ejecuta en DatabaseWorker::readerInstance() dentro de una
+     * ReadSnapshot; el visitor corre en ese hilo.
+     */
+    QFuture<bool> forEachInDateRangeAsync(const QDate& from, const QDate& to, SaleVisitor visitor,
+                                          ItemLoading loading = ItemLoading::Full);
 
     /**
      * @brief Obtener ventas del día
@@ -46,12 +98,21 @@ public:
     bool cancel(int saleId);
 
     /**
-     * @brief Generar siguiente número de factura
+     * @brief Reservar el siguiente número de comprobante de la serie
+     *
+     * Incrementa invoice_sequences: debe llamarse dentro de la transacción
+     * que guarda la venta, así el número queda bloqueado hasta el commit
+     * y vuelve a estar libre si la venta se revierte.
+     * @param series "BOLETA" o "FACTURA" (numeración independiente)
+     * @return Número de comprobante, o vacío si falla
      */
-    QString generateNextInvoiceNumber();
+    QString allocateInvoiceNumber(const QString& series);
 
     /**
-     * @brief Estadísticas de ventas
+     * @brief Estadísticas de ventas COMPLETED
+     *
+     * Se leen de sales_daily_summary: el costo depende de los días del
+     * rango, no de la cantidad de ventas.
      */
     struct SalesStats {
         double totalSales = 0.0;
@@ -63,7 +124,7 @@ public:
     SalesStats getStatsForDateRange(const QDate& from, const QDate& to);
 
     /**
-     * @brief Obtener ventas agrupadas por día en un rango
+     * @brief Obtener ventas COMPLETED agrupadas por día en un rango (desde el resumen diario)
      */
     struct DailySales {
         QDate date;
@@ -80,12 +141,63 @@ public:
         QString productName;
         double quantitySold = 0.0;
         double totalRevenue = 0.0;
+        double totalCost = 0.0;  // Según el precio de compra al momento de cada venta
     };
     QList<TopProduct> getTopProducts(const QDate& from, const QDate& to, int limit = 10);
 
-private:
-    Sale mapFromQuery(const class QSqlQuery& query);
+    /**
+     * @brief Producto que conviene reponer según su velocidad de venta
+     */
+    struct ReorderSuggestion {
+        int productId = 0;
+        QString productName;
+        double currentStock = 0.0;
+        double minimumStock = 0.0;
+        double dailyVelocity = 0.0;      // Unidades vendidas por día en la ventana
+        double daysOfCover = 0.0;        // Días que alcanza el stock actual
+        double suggestedQuantity = 0.0;  // Para cubrir coverDays por encima del mínimo
+    };
+
+    /**
+     * @brief Productos cuyo stock no cubre coverDays de venta (más el stock mínimo)
+     * @param windowDays Días hacia atrás (incluido hoy) para medir la velocidad
+     * @return Ordenados por días de cobertura, del más urgente al menos urgente
+     */
+    QList<ReorderSuggestion> getReorderSuggestions(int windowDays = 30, int coverDays = 14);
+
+    /**
+     * @brief Producto activo con stock y sin ventas recientes
+     */
+    struct DeadStockProduct {
+        int productId = 0;
+        QString productName;
+        double currentStock = 0.0;
+        double stockValue = 0.0;  // current_stock * purchase_price
+        QDate lastSaleDate;       // Inválida si nunca se vendió
+    };
+
+    /**
+     * @brief Productos sin ventas en los últimos days días, por valor inmovilizado
+     */
+    QList<DeadStockProduct> getDeadStock(int days = 90);
+
+    /**
+     * @brief Items de una venta (carga diferida tras ItemLoading::None)
+     */
     QList<SaleItem> loadSaleItems(int saleId);
+
+private:
+    /**
+     * @brief Columnas de Sale resueltas en el resultado (crear una vez tras exec())
+     */
+    static RowMapper saleRow(const QSqlQuery& query);
+    Sale mapFromQuery(const RowMapper& row);
+
+    /**
+     * @brief Columnas de SaleItem resueltas en el resultado (crear una vez tras exec())
+     */
+    static RowMapper saleItemRow(const QSqlQuery& query);
+    static SaleItem mapItemFromQuery(const RowMapper& row);
 };
 
 #endif // SALEREPOSITORY_H
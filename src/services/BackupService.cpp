@@ -0,0 +1,357 @@
+#include "BackupService.h"
+#include "../database/DatabaseManager.h"
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QThread>
+#include <QDateTime>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// Formato .db.qz: magic, tamaño de página y bloques qCompress serializados
+constexpr quint32 kSnapshotMagic = 0x515A4442;  // "QZDB"
+constexpr quint32 kSnapshotVersion = 1;
+constexpr qint64 kPagesPerChunk = 256;
+constexpr int kCompressionLevel = 6;
+const QString kSnapshotPattern = QStringLiteral("inventory-*.db.qz");
+}
+
+BackupService::BackupService(QObject *parent)
+    : QObject(parent)
+{
+    m_progressTimer.setInterval(250);
+    connect(&m_progressTimer, &QTimer::timeout, this, &BackupService::reportProgress);
+
+    m_databasePath = DatabaseManager::instance().databasePath();
+    if (!m_databasePath.isEmpty()) {
+        m_backupDir = QFileInfo(m_databasePath).absolutePath() + "/backups";
+    }
+}
+
+BackupService::~BackupService()
+{
+    if (m_thread) {
+        // VACUUM INTO no se puede interrumpir: esperar a que termine
+        m_thread->wait();
+        delete m_thread;
+    }
+}
+
+bool BackupService::startBackup()
+{
+    if (isRunning()) {
+        qWarning() << "Ya hay un respaldo en curso";
+        return false;
+    }
+
+    m_databasePath = DatabaseManager::instance().databasePath();
+    if (m_databasePath.isEmpty()) {
+        emit backupFailed("La base de datos no está inicializada");
+        return false;
+    }
+    if (m_backupDir.isEmpty()) {
+        m_backupDir = QFileInfo(m_databasePath).absolutePath() + "/backups";
+    }
+
+    if (!QDir().mkpath(m_backupDir)) {
+        emit backupFailed("No se pudo crear la carpeta de respaldos: " + m_backupDir);
+        return false;
+    }
+
+    delete m_thread;
+    m_tempPath = m_backupDir + "/.inventory-backup.tmp";
+    m_snapshotPath.clear();
+    m_errorMessage.clear();
+    m_pagesTotal.storeRelease(0);
+    m_pagesDone.storeRelease(0);
+    m_phaseStartMs.storeRelease(0);
+    m_phase.storeRelease(Copying);
+
+    qDebug() << "Iniciando respaldo en:" << m_backupDir;
+
+    m_elapsed.start();
+    m_thread = QThread::create([this]() { runBackup(); });
+    m_thread->setObjectName("DatabaseBackup");
+    connect(m_thread, &QThread::finished, this, &BackupService::onBackupFinished);
+    m_thread->start(QThread::LowPriority);
+    m_progressTimer.start();
+
+    return true;
+}
+
+bool BackupService::isRunning() const
+{
+    return m_thread && m_thread->isRunning();
+}
+
+QString BackupService::backupDirectory() const
+{
+    return m_backupDir;
+}
+
+void BackupService::setBackupDirectory(const QString& directory)
+{
+    if (isRunning()) {
+        qWarning() << "No se puede cambiar la carpeta durante un respaldo";
+        return;
+    }
+    m_backupDir = directory;
+}
+
+int BackupService::maxSnapshots() const
+{
+    return m_maxSnapshots;
+}
+
+void BackupService::setMaxSnapshots(int count)
+{
+    m_maxSnapshots = std::max(1, count);
+}
+
+QStringList BackupService::snapshots() const
+{
+    QStringList result;
+    if (m_backupDir.isEmpty()) {
+        return result;
+    }
+
+    // El nombre lleva la fecha (yyyyMMdd-HHmmss): el orden alfabético es cronológico
+    QDir dir(m_backupDir);
+    const QStringList names = dir.entryList({kSnapshotPattern}, QDir::Files, QDir::Name | QDir::Reversed);
+    for (const QString& name : names) {
+        result.append(dir.filePath(name));
+    }
+    return result;
+}
+
+void BackupService::runBackup()
+{
+    QString errorMessage;
+
+    if (!copySnapshot(errorMessage)) {
+        QFile::remove(m_tempPath);
+        m_errorMessage = errorMessage;
+        return;
+    }
+
+    const QString snapshotPath = QString("%1/inventory-%2.db.qz")
+                                     .arg(m_backupDir,
+                                          QDateTime::currentDateTime().toString("yyyyMMdd-HHmmss"));
+
+    const bool compressed = compressSnapshot(snapshotPath, errorMessage);
+    QFile::remove(m_tempPath);
+
+    if (!compressed) {
+        QFile::remove(snapshotPath);
+        m_errorMessage = errorMessage;
+        return;
+    }
+
+    m_snapshotPath = snapshotPath;
+    rotateSnapshots();
+}
+
+bool BackupService::copySnapshot(QString& errorMessage)
+{
+    const QString connectionName = "inventory_backup";
+    bool success = false;
+
+    {
+        // Conexión propia de solo lectura: no comparte caché ni transacciones con el pool
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        db.setDatabaseName(m_databasePath);
+        db.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000");
+
+        if (!db.open()) {
+            errorMessage = "Error abriendo conexión de respaldo: " + db.lastError().text();
+        } else {
+            QSqlQuery query(db);
+            if (query.exec("PRAGMA page_size") && query.next()) {
+                m_pageSize.storeRelease(std::max<qint64>(512, query.value(0).toLongLong()));
+            }
+            if (query.exec("PRAGMA page_count") && query.next()) {
+                m_pagesTotal.storeRelease(query.value(0).toLongLong());
+            }
+
+            QFile::remove(m_tempPath);  // VACUUM INTO exige un destino vacío
+            m_phaseStartMs.storeRelease(m_elapsed.elapsed());
+
+            // Instantánea consistente en una sola transacción de lectura
+            query.prepare("VACUUM INTO :path");
+            query.bindValue(":path", m_tempPath);
+            if (!query.exec()) {
+                errorMessage = "Error copiando la base de datos: " + query.lastError().text();
+            } else {
+                success = true;
+            }
+        }
+        db.close();
+    }
+
+    QSqlDatabase::removeDatabase(connectionName);
+    return success;
+}
+
+bool BackupService::compressSnapshot(const QString& targetPath, QString& errorMessage)
+{
+    QFile source(m_tempPath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        errorMessage = "Error leyendo la copia temporal: " + source.errorString();
+        return false;
+    }
+
+    QFile target(targetPath);
+    if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = "Error creando el respaldo: " + target.errorString();
+        return false;
+    }
+
+    const qint64 pageSize = m_pageSize.loadAcquire();
+    const qint64 chunkSize = pageSize * kPagesPerChunk;
+
+    // La copia compactada puede tener menos páginas que el original
+    m_pagesTotal.storeRelease((source.size() + pageSize - 1) / pageSize);
+    m_pagesDone.storeRelease(0);
+    m_phaseStartMs.storeRelease(m_elapsed.elapsed());
+    m_phase.storeRelease(Compressing);
+
+    QDataStream out(&target);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << kSnapshotMagic << kSnapshotVersion << static_cast<quint32>(pageSize);
+
+    while (!source.atEnd()) {
+        const QByteArray chunk = source.read(chunkSize);
+        if (chunk.isEmpty()) {
+            errorMessage = "Error leyendo la copia temporal: " + source.errorString();
+            return false;
+        }
+
+        out << qCompress(chunk, kCompressionLevel);
+        if (out.status() != QDataStream::Ok) {
+            errorMessage = "Error escribiendo el respaldo: " + target.errorString();
+            return false;
+        }
+
+        m_pagesDone.fetchAndAddRelease((chunk.size() + pageSize - 1) / pageSize);
+
+        // Ceder la CPU entre bloques para no competir con el punto de venta
+        QThread::yieldCurrentThread();
+    }
+
+    if (!target.flush()) {
+        errorMessage = "Error escribiendo el respaldo: " + target.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+void BackupService::rotateSnapshots()
+{
+    const QStringList existing = snapshots();
+    for (int i = m_maxSnapshots; i < existing.size(); ++i) {
+        if (QFile::remove(existing.at(i))) {
+            qDebug() << "Respaldo antiguo eliminado:" << existing.at(i);
+        }
+    }
+}
+
+bool BackupService::restoreSnapshot(const QString& snapshotPath, const QString& targetPath,
+                                    QString& errorMessage)
+{
+    QFile source(snapshotPath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        errorMessage = "Error abriendo el respaldo: " + source.errorString();
+        return false;
+    }
+
+    QDataStream in(&source);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    quint32 pageSize = 0;
+    in >> magic >> version >> pageSize;
+    if (magic != kSnapshotMagic || version != kSnapshotVersion) {
+        errorMessage = "El archivo no es un respaldo válido";
+        return false;
+    }
+
+    QFile target(targetPath);
+    if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        errorMessage = "Error creando la base de datos restaurada: " + target.errorString();
+        return false;
+    }
+
+    while (!in.atEnd()) {
+        QByteArray compressed;
+        in >> compressed;
+
+        const QByteArray chunk = qUncompress(compressed);
+        if (in.status() != QDataStream::Ok || chunk.isEmpty()) {
+            errorMessage = "El respaldo está dañado";
+            target.remove();
+            return false;
+        }
+
+        if (target.write(chunk) != chunk.size()) {
+            errorMessage = "Error escribiendo la base de datos restaurada: " + target.errorString();
+            target.remove();
+            return false;
+        }
+    }
+
+    qDebug() << "Respaldo restaurado en:" << targetPath;
+    return true;
+}
+
+void BackupService::reportProgress()
+{
+    const int phase = m_phase.loadAcquire();
+    if (phase == Idle) {
+        return;
+    }
+
+    const qint64 pageSize = m_pageSize.loadAcquire();
+    const qint64 pagesTotal = m_pagesTotal.loadAcquire();
+    qint64 pagesDone = m_pagesDone.loadAcquire();
+
+    if (phase == Copying) {
+        // VACUUM INTO no informa avance: se estima por el tamaño del destino
+        pagesDone = QFileInfo(m_tempPath).size() / pageSize;
+    }
+    pagesDone = std::min(pagesDone, pagesTotal);
+
+    const qint64 phaseMs = m_elapsed.elapsed() - m_phaseStartMs.loadAcquire();
+    const double megabytesPerSecond = phaseMs > 0
+        ? (pagesDone * pageSize / (1024.0 * 1024.0)) / (phaseMs / 1000.0)
+        : 0.0;
+
+    emit backupProgress(phase == Copying ? "copiando" : "comprimiendo",
+                        pagesTotal - pagesDone, pagesTotal, megabytesPerSecond);
+}
+
+void BackupService::onBackupFinished()
+{
+    m_progressTimer.stop();
+    reportProgress();
+    m_phase.storeRelease(Idle);
+
+    const qint64 elapsedMs = m_elapsed.elapsed();
+
+    if (m_snapshotPath.isEmpty()) {
+        qCritical() << "Respaldo fallido:" << m_errorMessage;
+        emit backupFailed(m_errorMessage);
+        return;
+    }
+
+    const qint64 snapshotBytes = QFileInfo(m_snapshotPath).size();
+    qDebug() << "Respaldo completado:" << m_snapshotPath
+             << "(" << snapshotBytes / 1024 << "KB en" << elapsedMs << "ms )";
+    emit backupCompleted(m_snapshotPath, snapshotBytes, elapsedMs);
+}
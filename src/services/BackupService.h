@@ -0,0 +1,132 @@
+#ifndef BACKUPSERVICE_H
+#define BACKUPSERVICE_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QAtomicInteger>
+
+class QThread;
+
+/**
+ * @brief Servicio de respaldo en caliente de la base de datos
+ *
+ * Características:
+ * - Copia una instantánea consistente con VACUUM INTO desde una conexión
+ *   propia de solo lectura, en un hilo de baja prioridad. En modo WAL la
+ *   lectura no bloquea a los escritores, por lo que las ventas continúan
+ *   durante el respaldo.
+ * - Comprime la instantánea por bloques (formato .db.qz, ver restoreSnapshot)
+ * - Rota los respaldos conservando los maxSnapshots() más recientes
+ * - Informa progreso en páginas restantes y velocidad (MB/s)
+ *
+ * El driver QSQLITE no expone la API sqlite3_backup_*, por eso la copia
+ * se hace con VACUUM INTO en lugar de copiar páginas por pasos.
+ */
+class BackupService : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BackupService(QObject *parent = nullptr);
+    ~BackupService();
+
+    /**
+     * @brief Iniciar un respaldo en segundo plano
+     * @return false si ya hay uno en curso o la base de datos no está abierta
+     */
+    bool startBackup();
+
+    /**
+     * @brief Verificar si hay un respaldo en curso
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Carpeta de respaldos (por defecto: backups/ junto a inventory.db)
+     */
+    QString backupDirectory() const;
+    void setBackupDirectory(const QString& directory);
+
+    /**
+     * @brief Cantidad de respaldos que se conservan (default: 7)
+     */
+    int maxSnapshots() const;
+    void setMaxSnapshots(int count);
+
+    /**
+     * @brief Respaldos existentes, del más reciente al más antiguo
+     */
+    QStringList snapshots() const;
+
+    /**
+     * @brief Descomprimir un respaldo .db.qz a un archivo SQLite
+     *
+     * No debe usarse sobre la base de datos abierta: restaurar a otra ruta
+     * y reemplazar inventory.db con la aplicación cerrada.
+     */
+    static bool restoreSnapshot(const QString& snapshotPath, const QString& targetPath,
+                                QString& errorMessage);
+
+signals:
+    /**
+     * @brief Progreso del respaldo
+     * @param phase "copiando" o "comprimiendo"
+     */
+    void backupProgress(const QString& phase, qint64 pagesRemaining, qint64 pagesTotal,
+                        double megabytesPerSecond);
+
+    void backupCompleted(const QString& snapshotPath, qint64 snapshotBytes, qint64 elapsedMs);
+    void backupFailed(const QString& errorMessage);
+
+private slots:
+    void reportProgress();
+    void onBackupFinished();
+
+private:
+    enum Phase { Idle, Copying, Compressing };
+
+    /**
+     * @brief Trabajo completo del hilo de respaldo
+     */
+    void runBackup();
+
+    /**
+     * @brief Instantánea consistente de la base de datos en m_tempPath
+     */
+    bool copySnapshot(QString& errorMessage);
+
+    /**
+     * @brief Comprimir m_tempPath en el archivo de respaldo final
+     */
+    bool compressSnapshot(const QString& targetPath, QString& errorMessage);
+
+    /**
+     * @brief Eliminar los respaldos más antiguos que maxSnapshots()
+     */
+    void rotateSnapshots();
+
+    QThread* m_thread = nullptr;
+    QTimer m_progressTimer;
+    QElapsedTimer m_elapsed;
+
+    QString m_databasePath;
+    QString m_backupDir;
+    QString m_tempPath;
+    int m_maxSnapshots = 7;
+
+    // Compartidos con el hilo de respaldo
+    QAtomicInt m_phase = Idle;
+    QAtomicInteger<qint64> m_pageSize = 4096;
+    QAtomicInteger<qint64> m_pagesTotal = 0;
+    QAtomicInteger<qint64> m_pagesDone = 0;
+    QAtomicInteger<qint64> m_phaseStartMs = 0;
+
+    // Escritos por el hilo de respaldo, leídos al terminar
+    QString m_snapshotPath;
+    QString m_errorMessage;
+};
+
+#endif // BACKUPSERVICE_H
@@ -0,0 +1,298 @@
+#include "CatalogIndex.h"
+#include "../database/DatabaseConnection.h"
+#include "../database/DatabaseWorker.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QElapsedTimer>
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QDebug>
+#include <utility>
+
+Product CatalogIndex::Entry::toProduct() const
+{
+    Product product;
+    product.id = id;
+    product.name = name;
+    product.sku = sku;
+    product.barcode = barcode;
+    product.salePrice = salePrice;
+    product.currentStock = currentStock;
+    product.minimumStock = minimumStock;
+    product.active = true;
+    return product;
+}
+
+CatalogIndex& CatalogIndex::instance()
+{
+    static CatalogIndex instance;
+    return instance;
+}
+
+bool CatalogIndex::load()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    {
+        QWriteLocker locker(&m_lock);
+        m_loading = true;
+        m_pending.clear();
+    }
+
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
+    query.setForwardOnly(true);
+
+    QList<Entry> entries;
+    const bool success = conn.exec(query,
+        "SELECT id, name, sku, barcode, sale_price, current_stock, minimum_stock "
+        "FROM products WHERE active = 1", Q_FUNC_INFO);
+
+    if (success) {
+        while (query.next()) {
+            Entry entry;
+            entry.id = query.value(0).toInt();
+            entry.name = query.value(1).toString();
+            entry.sku = query.value(2).toString();
+            entry.barcode = query.value(3).toString();
+            entry.salePrice = query.value(4).toDouble();
+            entry.currentStock = query.value(5).toDouble();
+            entry.minimumStock = query.value(6).toDouble();
+            entries.append(entry);
+        }
+    } else {
+        qCritical() << "Error cargando índice de catálogo:" << query.lastError().text();
+    }
+
+    QWriteLocker locker(&m_lock);
+    m_loading = false;
+
+    if (!success) {
+        m_pending.clear();
+        return false;
+    }
+
+    m_entries.clear();
+    m_freeSlots.clear();
+    m_byId.clear();
+    m_byBarcode.clear();
+    m_bySku.clear();
+    m_nameTrigrams.clear();
+
+    m_entries.reserve(entries.size());
+    m_byId.reserve(entries.size());
+    m_byBarcode.reserve(entries.size());
+    m_bySku.reserve(entries.size());
+
+    for (const Entry& entry : entries) {
+        upsertLocked(entry);
+    }
+
+    // Cambios confirmados durante la consulta, en orden de llegada
+    for (const PendingChange& change : std::as_const(m_pending)) {
+        switch (change.kind) {
+        case PendingChange::Upsert:
+            upsertLocked(change.entry);
+            break;
+        case PendingChange::Remove:
+            removeLocked(change.entry.id);
+            break;
+        case PendingChange::Stock:
+            updateStockLocked(change.entry.id, change.entry.currentStock);
+            break;
+        }
+    }
+    m_pending.clear();
+    m_loaded = true;
+
+    qDebug() << "Índice de catálogo cargado:" << m_byId.size() << "productos en"
+             << timer.elapsed() << "ms";
+    return true;
+}
+
+void CatalogIndex::loadAsync()
+{
+    DatabaseWorker::readerInstance().run([this]() { return load(); });
+}
+
+bool CatalogIndex::isLoaded() const
+{
+    QReadLocker locker(&m_lock);
+    return m_loaded;
+}
+
+int CatalogIndex::size() const
+{
+    QReadLocker locker(&m_lock);
+    return static_cast<int>(m_byId.size());
+}
+
+std::optional<CatalogIndex::Entry> CatalogIndex::findByCode(const QString& code) const
+{
+    QReadLocker locker(&m_lock);
+
+    const int* slot = m_byBarcode.find(code);
+    if (!slot) {
+        slot = m_bySku.find(code);
+    }
+
+    if (!slot) {
+        return std::nullopt;
+    }
+    return m_entries[*slot];
+}
+
+std::optional<CatalogIndex::Entry> CatalogIndex::findById(int productId) const
+{
+    QReadLocker locker(&m_lock);
+
+    const Entry* entry = entryLocked(productId);
+    if (!entry) {
+        return std::nullopt;
+    }
+    return *entry;
+}
+
+QList<int> CatalogIndex::fuzzySearch(const QString& text, int limit) const
+{
+    QReadLocker locker(&m_lock);
+
+    QList<int> productIds;
+    const QList<TrigramIndex::Match> matches = m_nameTrigrams.search(text, limit);
+    productIds.reserve(matches.size());
+    for (const TrigramIndex::Match& match : matches) {
+        productIds.append(m_entries[match.slot].id);
+    }
+    return productIds;
+}
+
+void CatalogIndex::upsert(const Product& product)
+{
+    Entry entry;
+    entry.id = product.id;
+    entry.name = product.name;
+    entry.sku = product.sku;
+    entry.barcode = product.barcode;
+    entry.salePrice = product.salePrice;
+    entry.currentStock = product.currentStock;
+    entry.minimumStock = product.minimumStock;
+
+    QWriteLocker locker(&m_lock);
+
+    if (m_loading) {
+        m_pending.append({product.active ? PendingChange::Upsert : PendingChange::Remove, entry});
+    } else if (m_loaded) {
+        if (product.active) {
+            upsertLocked(entry);
+        } else {
+            removeLocked(entry.id);
+        }
+    }
+}
+
+void CatalogIndex::remove(int productId)
+{
+    QWriteLocker locker(&m_lock);
+
+    if (m_loading) {
+        Entry entry;
+        entry.id = productId;
+        m_pending.append({PendingChange::Remove, entry});
+    } else if (m_loaded) {
+        removeLocked(productId);
+    }
+}
+
+void CatalogIndex::updateStock(int productId, double newStock)
+{
+    QWriteLocker locker(&m_lock);
+
+    if (m_loading) {
+        Entry entry;
+        entry.id = productId;
+        entry.currentStock = newStock;
+        m_pending.append({PendingChange::Stock, entry});
+    } else if (m_loaded) {
+        updateStockLocked(productId, newStock);
+    }
+}
+
+void CatalogIndex::upsertLocked(const Entry& entry)
+{
+    if (const int* found = m_byId.find(entry.id)) {
+        Entry& current = m_entries[*found];
+
+        // Caso común (precios, stock): mismos códigos y nombre, actualizar en su lugar
+        if (current.sku == entry.sku && current.barcode == entry.barcode) {
+            const bool renamed = current.name != entry.name;
+            current = entry;
+            if (renamed) {
+                m_nameTrigrams.insert(*found, entry.name);
+            }
+            return;
+        }
+
+        // Cambió un código: la clave anterior no debe quedar
+        removeLocked(entry.id);
+    }
+
+    int slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+        m_entries[slot] = entry;
+    } else {
+        slot = static_cast<int>(m_entries.size());
+        m_entries.push_back(entry);
+    }
+
+    m_byId.insert(entry.id, slot);
+    if (!entry.barcode.isEmpty()) {
+        m_byBarcode.insert(entry.barcode, slot);
+    }
+    if (!entry.sku.isEmpty()) {
+        m_bySku.insert(entry.sku, slot);
+    }
+    m_nameTrigrams.insert(slot, entry.name);
+}
+
+void CatalogIndex::removeLocked(int productId)
+{
+    const int* found = m_byId.find(productId);
+    if (!found) {
+        return;
+    }
+
+    const int slot = *found;
+    Entry& entry = m_entries[slot];
+
+    // Otro producto pudo tomar el mismo código (p. ej. tras desactivar este)
+    const int* barcodeSlot = m_byBarcode.find(entry.barcode);
+    if (barcodeSlot && *barcodeSlot == slot) {
+        m_byBarcode.remove(entry.barcode);
+    }
+    const int* skuSlot = m_bySku.find(entry.sku);
+    if (skuSlot && *skuSlot == slot) {
+        m_bySku.remove(entry.sku);
+    }
+
+    m_byId.remove(productId);
+    m_nameTrigrams.remove(slot);
+    entry = Entry();
+    m_freeSlots.push_back(slot);
+}
+
+void CatalogIndex::updateStockLocked(int productId, double newStock)
+{
+    const int* slot = m_byId.find(productId);
+    if (slot) {
+        m_entries[*slot].currentStock = newStock;
+    }
+}
+
+const CatalogIndex::Entry* CatalogIndex::entryLocked(int productId) const
+{
+    const int* slot = m_byId.find(productId);
+    return slot ? &m_entries[*slot] : nullptr;
+}
@@ -0,0 +1,128 @@
+#ifndef CATALOGINDEX_H
+#define CATALOGINDEX_H
+
+#include "../models/Product.h"
+#include "../utils/OpenAddressingMap.h"
+#include "../utils/TrigramIndex.h"
+#include <QString>
+#include <QList>
+#include <QReadWriteLock>
+#include <vector>
+#include <optional>
+
+/**
+ * @brief Índice en memoria de códigos de barras y SKU (Singleton)
+ *
+ * Resuelve el escaneo en el punto de venta sin ir a SQLite: código de
+ * barras o SKU -> registro compacto con lo necesario para agregar al
+ * carrito (nombre, precio, stock). También mantiene un índice de trigramas
+ * de los nombres para la búsqueda tolerante a errores (fuzzySearch).
+ *
+ * - Contiene solo productos activos
+ * - Se carga al iniciar (loadAsync) y ProductService lo actualiza con
+ *   DatabaseManager::runAfterCommit(), es decir, solo con datos confirmados
+ * - Thread-safe: las ventas asíncronas actualizan el stock desde el hilo
+ *   de base de datos
+ *
+ * Mientras no esté cargado (o ante un código desconocido) el llamador
+ * debe recurrir a ProductService.
+ */
+class CatalogIndex
+{
+public:
+    /**
+     * @brief Registro compacto de un producto
+     */
+    struct Entry {
+        int id = 0;
+        QString name;
+        QString sku;
+        QString barcode;
+        double salePrice = 0.0;
+        double currentStock = 0.0;
+        double minimumStock = 0.0;
+
+        /**
+         * @brief Producto con los campos del registro (activo)
+         */
+        Product toProduct() const;
+    };
+
+    static CatalogIndex& instance();
+
+    /**
+     * @brief Cargar todos los productos activos (usa la conexión del hilo)
+     * @return false si la consulta falló
+     */
+    bool load();
+
+    /**
+     * @brief Encolar load() en el hilo lector de DatabaseWorker
+     */
+    void loadAsync();
+
+    bool isLoaded() const;
+    int size() const;
+
+    /**
+     * @brief Buscar por código de barras y, si no hay, por SKU
+     */
+    std::optional<Entry> findByCode(const QString& code) const;
+    std::optional<Entry> findById(int productId) const;
+
+    /**
+     * @brief Búsqueda aproximada por nombre ("teclao mecanico" -> "Teclado Mecánico")
+     * @return IDs de productos, del más parecido al menos parecido
+     */
+    QList<int> fuzzySearch(const QString& text, int limit) const;
+
+    /**
+     * @brief Reflejar un producto creado o modificado (si está inactivo, se quita)
+     */
+    void upsert(const Product& product);
+
+    /**
+     * @brief Quitar un producto eliminado o desactivado
+     */
+    void remove(int productId);
+
+    /**
+     * @brief Actualizar solo el stock (movimientos y ventas)
+     */
+    void updateStock(int productId, double newStock);
+
+private:
+    CatalogIndex() = default;
+    CatalogIndex(const CatalogIndex&) = delete;
+    CatalogIndex& operator=(const CatalogIndex&) = delete;
+
+    /**
+     * @brief Cambio recibido mientras se carga, para reaplicarlo al terminar
+     */
+    struct PendingChange {
+        enum Kind { Upsert, Remove, Stock } kind;
+        Entry entry;
+    };
+
+    // Requieren m_lock tomado (escritura, salvo entryLocked)
+    void upsertLocked(const Entry& entry);
+    void removeLocked(int productId);
+    void updateStockLocked(int productId, double newStock);
+    const Entry* entryLocked(int productId) const;
+
+    mutable QReadWriteLock m_lock;
+
+    // Registros en un arreglo contiguo; los mapas guardan su posición
+    std::vector<Entry> m_entries;
+    std::vector<int> m_freeSlots;
+    OpenAddressingMap<int, int> m_byId;
+    OpenAddressingMap<QString, int> m_byBarcode;
+    OpenAddressingMap<QString, int> m_bySku;
+    TrigramIndex m_nameTrigrams;
+
+    bool m_loaded = false;
+    bool m_loading = false;
+    QList<PendingChange> m_pending;
+};
+
+#endif // CATALOGINDEX_H
@@ -1,6 +1,8 @@
 #include "ExcelImportService.h"
 #include "ProductService.h"
+#include "../database/DatabaseConnection.h"
 #include "../database/DatabaseManager.h"
+#include "../database/TransactionScope.h"
 #include <xlsxdocument.h>
 #include <xlsxcellrange.h>
 #include <QSqlQuery>
@@ -93,6 +95,21 @@ ExcelImportService::ImportResult ExcelImportService::importProducts(
 
     ProductService productService;
 
+    // Perfil de carga masiva mientras dure la importación
+    DatabaseManager& dbManager = DatabaseManager::instance();
+    const QString previousProfile = dbManager.storageProfileName();
+    dbManager.setStorageProfile("bulk-import");
+
+    // Toda la importación en una sola transacción; una fila rechazada
+    // (p. ej. código de barras repetido) no descarta las demás
+    TransactionScope importTransaction;
+    if (!importTransaction.isActive()) {
+        dbManager.setStorageProfile(previousProfile);
+        result.success = false;
+        result.errors.append("Error iniciando transacción de importación");
+        return result;
+    }
+
     int totalRows = xlsx.dimension().lastRow();
     int startRow = skipFirstRow ? 2 : 1;
     result.totalRows = totalRows - startRow + 1;
@@ -109,6 +126,11 @@ ExcelImportService::ImportResult ExcelImportService::importProducts(
         }
     }
     
+    QList<Product> products;
+    QList<int> productRows;  // Fila de Excel de cada producto, para los errores
+    products.reserve(result.totalRows);
+    productRows.reserve(result.totalRows);
+
     for (int rowIndex = startRow; rowIndex <= totalRows; ++rowIndex) {
         // Actualizar progreso
         int progress = ((rowIndex - startRow + 1) * 100) / result.totalRows;
@@ -144,41 +166,32 @@ ExcelImportService::ImportResult ExcelImportService::importProducts(
         }
 
         qDebug() << "Producto mapeado:" << product.name << "|" << product.sku;
-        
-        // Verificar si el SKU ya existe
-        auto existingProduct = productService.getProductBySku(product.sku);
-        
-        if (existingProduct.has_value()) {
-            // El producto ya existe, ACTUALIZAR en lugar de crear
-            qDebug() << "  ⚠️ Producto existente encontrado (ID:" << existingProduct->id << "), actualizando...";
-            
-            // Mantener el ID del producto existente
-            product.id = existingProduct->id;
-            
-            // Actualizar producto
-            if (productService.updateProduct(product, errorMessage)) {
-                qDebug() << "✓ Producto actualizado exitosamente";
-                result.importedRows++;
-            } else {
-                qWarning() << "✗ Error actualizando:" << errorMessage;
-                result.failedRows++;
-                result.errors.append(QString("Fila %1: %2").arg(rowIndex).arg(errorMessage));
-            }
+
+        products.append(product);
+        productRows.append(rowIndex);
+    }
+
+    // Guardar en bloque: los SKU existentes se actualizan, los nuevos se crean
+    emit importProgress(100, QString("Guardando %1 productos...").arg(products.size()));
+    const auto outcomes = productService.upsertProducts(products);
+
+    for (int i = 0; i < outcomes.size(); ++i) {
+        if (outcomes.at(i).status == ProductRepository::UpsertOutcome::Failed) {
+            result.failedRows++;
+            result.errors.append(QString("Fila %1: %2").arg(productRows.at(i)).arg(outcomes.at(i).errorMessage));
         } else {
-            // El producto no existe, CREAR nuevo
-            qDebug() << "  ➕ Producto nuevo, creando...";
-            
-            if (productService.createProduct(product, errorMessage)) {
-                qDebug() << "✓ Producto creado exitosamente";
-                result.importedRows++;
-            } else {
-                qWarning() << "✗ Error creando:" << errorMessage;
-                result.failedRows++;
-                result.errors.append(QString("Fila %1: %2").arg(rowIndex).arg(errorMessage));
-            }
+            result.importedRows++;
         }
     }
 
+    if (!importTransaction.commit()) {
+        result.importedRows = 0;
+        result.failedRows = result.totalRows;
+        result.errors.append("Error confirmando la importación; no se guardó ninguna fila");
+    }
+    // El perfil se restaura fuera de la transacción (journal_mode no cambia dentro)
+    dbManager.setStorageProfile(previousProfile);
+
     result.success = (result.importedRows > 0);
     emit importProgress(100, "Importación completada");
     emit importCompleted(result.importedRows, result.failedRows);
@@ -205,7 +218,8 @@ bool ExcelImportService::saveTemplate(const QString& templateName,
     QString jsonStr = doc.toJson(QJsonDocument::Compact);
 
     // Guardar en base de datos
-    QSqlQuery query(DatabaseManager::instance().database());
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
     query.prepare(
         "INSERT OR REPLACE INTO import_templates (name, column_mapping, updated_at) "
         "VALUES (:name, :mapping, datetime('now'))"
@@ -213,7 +227,7 @@ bool ExcelImportService::saveTemplate(const QString& templateName,
     query.bindValue(":name", templateName);
     query.bindValue(":mapping", jsonStr);
 
-    if (!query.exec()) {
+    if (!conn.exec(query, Q_FUNC_INFO)) {
         errorMessage = query.lastError().text();
         qCritical() << "Error guardando plantilla:" << errorMessage;
         return false;
@@ -226,11 +240,12 @@ QList<ExcelImportService::ColumnMapping> ExcelImportService::loadTemplate(const
 {
     QList<ColumnMapping> mappings;
 
-    QSqlQuery query(DatabaseManager::instance().database());
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
     query.prepare("SELECT column_mapping FROM import_templates WHERE name = :name");
     query.bindValue(":name", templateName);
 
-    if (!query.exec() || !query.next()) {
+    if (!conn.exec(query, Q_FUNC_INFO) || !query.next()) {
         return mappings;
     }
 
@@ -254,9 +269,10 @@ QList<ExcelImportService::ColumnMapping> ExcelImportService::loadTemplate(const
 QStringList ExcelImportService::getTemplates()
 {
     QStringList templates;
-    QSqlQuery query(DatabaseManager::instance().database());
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
     
-    if (!query.exec("SELECT name FROM import_templates ORDER BY name")) {
+    if (!conn.exec(query, "SELECT name FROM import_templates ORDER BY name", Q_FUNC_INFO)) {
         return templates;
     }
 
@@ -269,10 +285,11 @@ QStringList ExcelImportService::getTemplates()
 
 bool ExcelImportService::deleteTemplate(const QString& templateName)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
     query.prepare("DELETE FROM import_templates WHERE name = :name");
     query.bindValue(":name", templateName);
-    return query.exec();
+    return conn.exec(query, Q_FUNC_INFO);
 }
 
 QStringList ExcelImportService::getAvailableFields()
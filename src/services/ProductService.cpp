@@ -1,9 +1,25 @@
 #include "ProductService.h"
+#include "../database/DatabaseConnection.h"
+#include "../database/TransactionScope.h"
 #include "../database/DatabaseManager.h"
+#include "../database/DatabaseWorker.h"
+#include "../database/RowMapper.h"
+#include "../database/ReadSnapshot.h"
+#include "CatalogIndex.h"
 #include <QSqlQuery>
 #include <QSqlError>
+#include <QHash>
+#include <QSet>
+#include <utility>
 #include <QDebug>
 
+namespace {
+// Búsqueda: máximo de resultados y mínimo de coincidencias exactas (FTS5)
+// por debajo del cual se agregan las aproximadas
+constexpr int kSearchLimit = 50;
+constexpr int kMinExactResults = 5;
+}
+
 ProductService::ProductService(QObject *parent)
     : QObject(parent)
 {
@@ -16,6 +32,13 @@ bool ProductService::createProduct(Product& product, QString& errorMessage)
         return false;
     }
 
+    // Producto, categoría y stock inicial se guardan juntos
+    TransactionScope transaction;
+    if (!transaction.isActive()) {
+        errorMessage = "Error iniciando transacción";
+        return false;
+    }
+
     // Obtener o crear categoryId a partir del nombre
     if (!product.categoryName.isEmpty()) {
         product.categoryId = getOrCreateCategoryId(product.categoryName);
@@ -29,10 +52,22 @@ bool ProductService::createProduct(Product& product, QString& errorMessage)
     }
 
     // Registrar stock inicial si es mayor a 0
-    if (product.currentStock > 0) {
-        logStockMovement(productId, getMovementTypeId("AJUSTE_POSITIVO"),
-                        product.currentStock, 0, product.currentStock,
-                        product.purchasePrice, "Stock inicial", "");
+    if (product.currentStock > 0
+        && !logStockMovement(productId, getMovementTypeId("AJUSTE_POSITIVO"),
+                             product.currentStock, 0, product.currentStock,
+                             product.purchasePrice, "Stock inicial", "")) {
+        errorMessage = "Error registrando stock inicial";
+        return false;
+    }
+
+    const Product created = product;
+    DatabaseManager::instance().runAfterCommit([created]() {
+        CatalogIndex::instance().upsert(created);
+    });
+
+    if (!transaction.commit()) {
+        errorMessage = "Error al guardar el producto en la base de datos";
+        return false;
     }
 
     emit productCreated(productId);
@@ -70,6 +105,10 @@ bool ProductService::updateProduct(const Product& product, QString& errorMessage
         return false;
     }
 
+    DatabaseManager::instance().runAfterCommit([updatedProduct]() {
+        CatalogIndex::instance().upsert(updatedProduct);
+    });
+
     // Verificar si el stock cambió (aunque no debería cambiar directamente, solo por movimientos)
     if (currentProduct->currentStock != product.currentStock) {
         emit stockChanged(product.id, currentProduct->currentStock, product.currentStock);
@@ -97,10 +136,111 @@ bool ProductService::deleteProduct(int productId, QString& errorMessage)
         return false;
     }
 
+    DatabaseManager::instance().runAfterCommit([productId]() {
+        CatalogIndex::instance().remove(productId);
+    });
+
     emit productDeleted(productId);
     return true;
 }
 
+QList<ProductRepository::UpsertOutcome> ProductService::upsertProducts(QList<Product>& products)
+{
+    using Outcome = ProductRepository::UpsertOutcome;
+    QList<Outcome> outcomes(products.size());
+
+    TransactionScope transaction;
+    if (!transaction.isActive()) {
+        for (Outcome& outcome : outcomes) {
+            outcome.errorMessage = "Error iniciando transacción";
+        }
+        return outcomes;
+    }
+
+    // Validar sin consultas por fila: SKU y código de barras los controla
+    // la base al guardar (ON CONFLICT(sku) y el índice UNIQUE de barcode)
+    QList<Product> valid;
+    QList<int> validRows;
+    QHash<QString, int> categoryIds;
+    valid.reserve(products.size());
+
+    for (int row = 0; row < products.size(); ++row) {
+        Product& product = products[row];
+        if (!validateProductFields(product, outcomes[row].errorMessage)) {
+            continue;
+        }
+
+        const QString categoryKey = product.categoryName.trimmed().toLower();
+        if (categoryKey.isEmpty()) {
+            product.categoryId = 0;
+        } else {
+            auto category = categoryIds.constFind(categoryKey);
+            if (category == categoryIds.constEnd()) {
+                category = categoryIds.insert(categoryKey, getOrCreateCategoryId(product.categoryName));
+            }
+            product.categoryId = *category;
+        }
+
+        valid.append(product);
+        validRows.append(row);
+    }
+
+    const QList<Outcome> saved = m_productRepo.upsertMany(valid);
+
+    const int initialStockTypeId = getMovementTypeId("AJUSTE_POSITIVO");
+    QList<Product> changed;
+
+    for (int i = 0; i < valid.size(); ++i) {
+        const int row = validRows.at(i);
+        const Product& product = valid.at(i);
+        outcomes[row] = saved.at(i);
+        products[row].id = product.id;
+
+        if (saved.at(i).status == Outcome::Inserted && product.currentStock > 0
+            && !logStockMovement(product.id, initialStockTypeId, product.currentStock, 0,
+                                 product.currentStock, product.purchasePrice, "Stock inicial", "")) {
+            // Sin el kardex el stock inicial quedaría sin respaldo: se descarta todo
+            for (Outcome& outcome : outcomes) {
+                outcome.status = Outcome::Failed;
+                outcome.errorMessage = "Error registrando stock inicial";
+            }
+            return outcomes;
+        }
+
+        if (saved.at(i).status == Outcome::Inserted || saved.at(i).status == Outcome::Updated) {
+            changed.append(product);
+        }
+    }
+
+    DatabaseManager::instance().runAfterCommit([changed]() {
+        for (const Product& product : changed) {
+            CatalogIndex::instance().upsert(product);
+        }
+    });
+
+    if (!transaction.commit()) {
+        for (Outcome& outcome : outcomes) {
+            outcome.status = Outcome::Failed;
+            outcome.errorMessage = "Error al guardar los productos en la base de datos";
+        }
+        return outcomes;
+    }
+
+    for (int i = 0; i < valid.size(); ++i) {
+        const Outcome& outcome = saved.at(i);
+        if (outcome.status == Outcome::Inserted) {
+            emit productCreated(outcome.id);
+        } else if (outcome.status == Outcome::Updated) {
+            if (outcome.previousStock != valid.at(i).currentStock) {
+                emit stockChanged(outcome.id, outcome.previousStock, valid.at(i).currentStock);
+            }
+            emit productUpdated(outcome.id);
+        }
+    }
+
+    return outcomes;
+}
+
 std::optional<Product> ProductService::getProduct(int productId)
 {
     return m_productRepo.findById(productId);
@@ -123,7 +263,111 @@ QList<Product> ProductService::getAllProducts(bool activeOnly)
 
 QList<Product> ProductService::searchProducts(const QString& searchTerm)
 {
-    return m_productRepo.searchByName(searchTerm);
+    QList<Product> products = m_productRepo.search(searchTerm, kSearchLimit);
+    if (products.size() >= kMinExactResults) {
+        return products;
+    }
+
+    // Pocas coincidencias exactas: completar con nombres parecidos (errores de tipeo)
+    QSet<int> seen;
+    for (const Product& product : std::as_const(products)) {
+        seen.insert(product.id);
+    }
+    products.append(m_productRepo.findByIds(fuzzyCandidates(searchTerm, seen)));
+    return products;
+}
+
+QFuture<QList<Product>> ProductService::getAllProductsAsync(bool activeOnly)
+{
+    return m_productRepo.findAllAsync(activeOnly);
+}
+
+QFuture<QList<Product>> ProductService::searchProductsAsync(const QString& searchTerm)
+{
+    return DatabaseWorker::instance().run([searchTerm]() {
+        return ProductService().searchProducts(searchTerm);
+    });
+}
+
+QFuture<QList<ProductSummary>> ProductService::getProductPageAsync(const QString& afterName, int afterId,
+                                                                  int limit,
+                                                                  const ProductRepository::PageFilters& filters)
+{
+    return m_productRepo.findPageAsync(afterName, afterId, limit, filters);
+}
+
+QFuture<QList<ProductSummary>> ProductService::searchProductSummariesAsync(const QString& searchTerm)
+{
+    return DatabaseWorker::instance().run([searchTerm]() {
+        return ProductService().searchProductSummaries(searchTerm);
+    });
+}
+
+QList<ProductSummary> ProductService::getProductSummaries(bool activeOnly)
+{
+    return m_productRepo.findAllSummaries(activeOnly);
+}
+
+QList<ProductSummary> ProductService::searchProductSummaries(const QString& searchTerm)
+{
+    QList<ProductSummary> products = m_productRepo.searchSummaries(searchTerm, kSearchLimit);
+    if (products.size() >= kMinExactResults) {
+        return products;
+    }
+
+    QSet<int> seen;
+    for (const ProductSummary& product : std::as_const(products)) {
+        seen.insert(product.id);
+    }
+    products.append(m_productRepo.findSummariesByIds(fuzzyCandidates(searchTerm, seen)));
+    return products;
+}
+
+QList<int> ProductService::fuzzyCandidates(const QString& searchTerm, const QSet<int>& exclude)
+{
+    CatalogIndex& index = CatalogIndex::instance();
+    if (!index.isLoaded()) {
+        return {};
+    }
+
+    QList<int> candidates;
+    const QList<int> ids = index.fuzzySearch(searchTerm, kSearchLimit);
+    for (int id : ids) {
+        if (!exclude.contains(id) && candidates.size() + exclude.size() < kSearchLimit) {
+            candidates.append(id);
+        }
+    }
+    return candidates;
+}
+
+QList<ProductSummary> ProductService::getProductSummariesByCategory(int categoryId)
+{
+    return m_productRepo.findSummariesByCategory(categoryId);
+}
+
+QList<ProductSummary> ProductService::getLowStockProductSummaries()
+{
+    return m_productRepo.findLowStockSummaries();
+}
+
+qint64 ProductService::currentProductVersion()
+{
+    return m_productRepo.currentChangeVersion();
+}
+
+QFuture<ProductRepository::ChangeSet> ProductService::getProductChangesAsync(qint64 sinceVersion)
+{
+    return m_productRepo.changesSinceAsync(sinceVersion);
+}
+
+int ProductService::countProducts()
+{
+    return m_productRepo.count();
+}
+
+int ProductService::countLowStockProducts()
+{
+    return m_productRepo.countLowStock();
 }
 
 QList<Product> ProductService::getProductsByCategory(int categoryId)
@@ -163,17 +407,20 @@ bool ProductService::registerStockMovement(int productId, const QString& movemen
     double previousStock = product->currentStock;
     double newStock = previousStock;
 
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare("SELECT affects_stock FROM movement_types WHERE id = :id");
-    query.bindValue(":id", movementTypeId);
-    
-    if (!query.exec() || !query.next()) {
-        errorMessage = "Error obteniendo tipo de movimiento";
-        qWarning() << "  " << errorMessage;
-        return false;
-    }
+    DatabaseConnection conn;
+    int affectsStock = 0;
+    {
+        auto query = conn.prepare("SELECT affects_stock FROM movement_types WHERE id = :id");
+        query->bindValue(":id", movementTypeId);
+
+        if (!conn.exec(query, Q_FUNC_INFO) || !query->next()) {
+            errorMessage = "Error obteniendo tipo de movimiento";
+            qWarning() << "  " << errorMessage;
+            return false;
+        }
 
-    int affectsStock = query.value(0).toInt();
+        affectsStock = query->value(0).toInt();
+    }
     newStock += (quantity * affectsStock);
     
     qDebug() << "  Previous stock:" << previousStock << "Affects:" << affectsStock << "New stock:" << newStock;
@@ -186,8 +433,14 @@ bool ProductService::registerStockMovement(int productId, const QString& movemen
         return false;
     }
 
-    // NO iniciar transacción aquí - debe ser manejada por el servicio que llama (SalesService)
-    // La transacción ya fue iniciada por SalesService::createSale()
+    // Stock y movimiento en un mismo alcance: si lo llama SalesService::createSale()
+    // es un savepoint dentro de la transacción de la venta
+    TransactionScope transaction;
+    if (!transaction.isActive()) {
+        errorMessage = "Error iniciando transacción";
+        qCritical() << "  " << errorMessage;
+        return false;
+    }
 
     // Actualizar stock del producto
     if (!m_productRepo.updateStock(productId, newStock)) {
@@ -208,8 +461,16 @@ bool ProductService::registerStockMovement(int productId, const QString& movemen
     
     qDebug() << "  Movement logged successfully";
 
-    // NO confirmar transacción aquí - la maneja el servicio superior
-    // SalesService::createSale() hará el commit de toda la transacción
+    // Si es parte de una venta, el índice se actualiza al confirmarse la venta
+    DatabaseManager::instance().runAfterCommit([productId, newStock]() {
+        CatalogIndex::instance().updateStock(productId, newStock);
+    });
+
+    if (!transaction.commit()) {
+        errorMessage = "Error confirmando movimiento de stock";
+        qCritical() << "  " << errorMessage;
+        return false;
+    }
 
     emit stockChanged(productId, previousStock, newStock);
 
@@ -243,41 +504,75 @@ bool ProductService::adjustStock(int productId, double newStock, const QString&
 QList<StockMovement> ProductService::getStockHistory(int productId)
 {
     QList<StockMovement> movements;
-    QSqlQuery query(DatabaseManager::instance().database());
-    
+    forEachStockMovement(productId, [&movements](const StockMovement& movement) {
+        movements.append(movement);
+        return true;
+    });
+    return movements;
+}
+
+bool ProductService::forEachStockMovement(int productId, const StockMovementVisitor& visitor)
+{
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
+    query.setForwardOnly(true);
+
+    // id DESC = orden de registro; sale del índice por producto sin ordenar en memoria
     query.prepare(
         "SELECT sm.*, mt.name as movement_type_name, mt.code as movement_type_code "
         "FROM stock_movements sm "
         "INNER JOIN movement_types mt ON sm.movement_type_id = mt.id "
         "WHERE sm.product_id = :product_id "
-        "ORDER BY sm.created_at DESC"
+        "ORDER BY sm.id DESC"
     );
     query.bindValue(":product_id", productId);
 
-    if (!query.exec()) {
+    if (!conn.exec(query, Q_FUNC_INFO)) {
         qCritical() << "Error obteniendo historial de stock:" << query.lastError().text();
-        return movements;
+        return false;
     }
 
+    enum {
+        ColId, ColProductId, ColTypeId, ColTypeName, ColTypeCode, ColQuantity,
+        ColPreviousStock, ColNewStock, ColUnitPrice, ColReference, ColNotes,
+        ColCreatedAt, ColCreatedBy
+    };
+    const RowMapper row(query, {
+        "id", "product_id", "movement_type_id", "movement_type_name", "movement_type_code",
+        "quantity", "previous_stock", "new_stock", "unit_price", "reference", "notes",
+        "created_at", "created_by"
+    });
+
     while (query.next()) {
         StockMovement movement;
-        movement.id = query.value("id").toInt();
-        movement.productId = query.value("product_id").toInt();
-        movement.movementTypeId = query.value("movement_type_id").toInt();
-        movement.movementTypeName = query.value("movement_type_name").toString();
-        movement.movementTypeCode = query.value("movement_type_code").toString();
-        movement.quantity = query.value("quantity").toDouble();
-        movement.previousStock = query.value("previous_stock").toDouble();
-        movement.newStock = query.value("new_stock").toDouble();
-        movement.unitPrice = query.value("unit_price").toDouble();
-        movement.reference = query.value("reference").toString();
-        movement.notes = query.value("notes").toString();
-        movement.createdAt = QDateTime::fromString(query.value("created_at").toString(), Qt::ISODate);
-        movement.createdBy = query.value("created_by").toString();
-        movements.append(movement);
+        movement.id = row.toInt(ColId);
+        movement.productId = row.toInt(ColProductId);
+        movement.movementTypeId = row.toInt(ColTypeId);
+        movement.movementTypeName = row.toString(ColTypeName);
+        movement.movementTypeCode = row.toString(ColTypeCode);
+        movement.quantity = row.toDouble(ColQuantity);
+        movement.previousStock = row.toDouble(ColPreviousStock);
+        movement.newStock = row.toDouble(ColNewStock);
+        movement.unitPrice = row.toDouble(ColUnitPrice);
+        movement.reference = row.toString(ColReference);
+        movement.notes = row.toString(ColNotes);
+        movement.createdAt = row.toDateTime(ColCreatedAt);
+        movement.createdBy = row.toString(ColCreatedBy);
+
+        if (!visitor(movement)) {
+            break;
+        }
     }
 
-    return movements;
+    return true;
+}
+
+QFuture<bool> ProductService::forEachStockMovementAsync(int productId, StockMovementVisitor visitor)
+{
+    return DatabaseWorker::readerInstance().run([productId, visitor]() {
+        ReadSnapshot snapshot;
+        return ProductService().forEachStockMovement(productId, visitor);
+    });
 }
 
 bool ProductService::isSkuUnique(const QString& sku, int excludeProductId)
@@ -301,6 +596,27 @@ bool ProductService::isBarcodeUnique(const QString& barcode, int excludeProductI
 }
 
 bool ProductService::validateProduct(const Product& product, QString& errorMessage)
+{
+    if (!validateProductFields(product, errorMessage)) {
+        return false;
+    }
+
+    // Validar unicidad de SKU
+    if (!product.sku.isEmpty() && !isSkuUnique(product.sku, product.id)) {
+        errorMessage = QString("El SKU '%1' ya está en uso").arg(product.sku);
+        return false;
+    }
+
+    // Validar unicidad de código de barras
+    if (!product.barcode.isEmpty() && !isBarcodeUnique(product.barcode, product.id)) {
+        errorMessage = QString("El código de barras '%1' ya está en uso").arg(product.barcode);
+        return false;
+    }
+
+    return true;
+}
+
+bool ProductService::validateProductFields(const Product& product, QString& errorMessage)
 {
     if (product.name.trimmed().isEmpty()) {
         errorMessage = "El nombre del producto es obligatorio";
@@ -322,18 +638,6 @@ bool ProductService::validateProduct(const Product& product, QString& errorMessa
         return false;
     }
 
-    // Validar unicidad de SKU
-    if (!product.sku.isEmpty() && !isSkuUnique(product.sku, product.id)) {
-        errorMessage = QString("El SKU '%1' ya está en uso").arg(product.sku);
-        return false;
-    }
-
-    // Validar unicidad de código de barras
-    if (!product.barcode.isEmpty() && !isBarcodeUnique(product.barcode, product.id)) {
-        errorMessage = QString("El código de barras '%1' ya está en uso").arg(product.barcode);
-        return false;
-    }
-
     return true;
 }
 
@@ -348,25 +652,25 @@ bool ProductService::logStockMovement(int productId, int movementTypeId, double
                                      double previousStock, double newStock, double unitPrice,
                                      const QString& reference, const QString& notes)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare(
+    DatabaseConnection conn;
+    auto query = conn.prepare(
         "INSERT INTO stock_movements (product_id, movement_type_id, quantity, "
         "previous_stock, new_stock, unit_price, reference, notes) "
         "VALUES (:product_id, :movement_type_id, :quantity, :previous_stock, "
         ":new_stock, :unit_price, :reference, :notes)"
     );
 
-    query.bindValue(":product_id", productId);
-    query.bindValue(":movement_type_id", movementTypeId);
-    query.bindValue(":quantity", quantity);
-    query.bindValue(":previous_stock", previousStock);
-    query.bindValue(":new_stock", newStock);
-    query.bindValue(":unit_price", unitPrice);
-    query.bindValue(":reference", reference);
-    query.bindValue(":notes", notes);
-
-    if (!query.exec()) {
-        qCritical() << "Error registrando movimiento de stock:" << query.lastError().text();
+    query->bindValue(":product_id", productId);
+    query->bindValue(":movement_type_id", movementTypeId);
+    query->bindValue(":quantity", quantity);
+    query->bindValue(":previous_stock", previousStock);
+    query->bindValue(":new_stock", newStock);
+    query->bindValue(":unit_price", unitPrice);
+    query->bindValue(":reference", reference);
+    query->bindValue(":notes", notes);
+
+    if (!conn.exec(query, Q_FUNC_INFO)) {
+        qCritical() << "Error registrando movimiento de stock:" << query->lastError().text();
         return false;
     }
 
@@ -375,12 +679,12 @@ bool ProductService::logStockMovement(int productId, int movementTypeId, double
 
 int ProductService::getMovementTypeId(const QString& code)
 {
-    QSqlQuery query(DatabaseManager::instance().database());
-    query.prepare("SELECT id FROM movement_types WHERE code = :code");
-    query.bindValue(":code", code);
+    DatabaseConnection conn;
+    auto query = conn.prepare("SELECT id FROM movement_types WHERE code = :code");
+    query->bindValue(":code", code);
 
-    if (query.exec() && query.next()) {
-        return query.value(0).toInt();
+    if (conn.exec(query, Q_FUNC_INFO) && query->next()) {
+        return query->value(0).toInt();
     }
 
     return 0;
@@ -392,13 +696,14 @@ int ProductService::getOrCreateCategoryId(const QString& categoryName)
         return 0;
     }
 
-    QSqlQuery query(DatabaseManager::instance().database());
+    DatabaseConnection conn;
+    QSqlQuery query(conn.database());
     
     // Buscar categoría existente
     query.prepare("SELECT id FROM categories WHERE name = :name COLLATE NOCASE");
     query.bindValue(":name", categoryName.trimmed());
     
-    if (query.exec() && query.next()) {
+    if (conn.exec(query, Q_FUNC_INFO) && query.next()) {
         return query.value(0).toInt();
     }
     
@@ -406,7 +711,7 @@ int ProductService::getOrCreateCategoryId(const QString& categoryName)
     query.prepare("INSERT INTO categories (name) VALUES (:name)");
     query.bindValue(":name", categoryName.trimmed());
     
-    if (query.exec()) {
+    if (conn.exec(query, Q_FUNC_INFO)) {
         return query.lastInsertId().toInt();
     }
     
@@ -2,10 +2,14 @@
 #define PRODUCTSERVICE_H
 
 #include "../models/Product.h"
+#include "../models/ProductSummary.h"
 #include "../models/StockMovement.h"
 #include "../repositories/ProductRepository.h"
 #include <QObject>
 #include <QList>
+#include <QFuture>
+#include <QSet>
+#include <functional>
 #include <optional>
 
 /**
@@ -36,6 +40,18 @@ public:
      */
     bool deleteProduct(int productId, QString& errorMessage);
 
+    /**
+     * @brief Crear o actualizar productos en bloque, identificados por SKU
+     *
+     * Para importaciones y listas de precios: valida cada producto,
+     * resuelve las categorías por nombre y guarda todo con
+     * ProductRepository::upsertMany() en una sola transacción. Los productos
+     * nuevos con stock registran su movimiento de stock inicial.
+     *
+     * @return Un resultado por producto, en el mismo orden
+     */
+    QList<ProductRepository::UpsertOutcome> upsertProducts(QList<Product>& products);
+
     /**
      * @brief Buscar producto
      */
@@ -47,10 +63,47 @@ public:
      * @brief Listar productos
      */
     QList<Product> getAllProducts(bool activeOnly = true);
+    /**
+     * @brief Búsqueda por texto (FTS5); si hay pocas coincidencias exactas
+     *        agrega las aproximadas por nombre ("teclao" -> "Teclado")
+     */
     QList<Product> searchProducts(const QString& searchTerm);
     QList<Product> getProductsByCategory(int categoryId);
     QList<Product> getLowStockProducts();
 
+    /**
+     * @brief Listados livianos para pantallas de lista (ver ProductSummary)
+     */
+    QList<ProductSummary> getProductSummaries(bool activeOnly = true);
+    QList<ProductSummary> searchProductSummaries(const QString& searchTerm);
+    QList<ProductSummary> getProductSummariesByCategory(int categoryId);
+    QList<ProductSummary> getLowStockProductSummaries();
+
+    /**
+     * @brief Conteos para el dashboard (no cargan los productos)
+     */
+    int countProducts();
+    int countLowStockProducts();
+
+    /**
+     * @brief Versiones asíncronas (se ejecutan en DatabaseWorker)
+     */
+    QFuture<QList<Product>> getAllProductsAsync(bool activeOnly = true);
+    QFuture<QList<Product>> searchProductsAsync(const QString& searchTerm);
+    QFuture<QList<ProductSummary>> searchProductSummariesAsync(const QString& searchTerm);
+
+    /**
+     * @brief Página de productos por cursor (ver ProductRepository::findPage)
+     */
+    QFuture<QList<ProductSummary>> getProductPageAsync(const QString& afterName, int afterId, int limit,
+                                                       const ProductRepository::PageFilters& filters);
+
+    /**
+     * @brief Sincronización incremental (ver ProductRepository::changesSince)
+     */
+    qint64 currentProductVersion();
+    QFuture<ProductRepository::ChangeSet> getProductChangesAsync(qint64 sinceVersion);
+
     /**
      * @brief Movimientos de stock
      */
@@ -69,6 +122,26 @@ public:
      */
     QList<StockMovement> getStockHistory(int productId);
 
+    /**
+     * @brief Visitor de movimientos: devolver false detiene el recorrido
+     */
+    using StockMovementVisitor = std::function<bool(const StockMovement&)>;
+
+    /**
+     * @brief Recorrer el Kardex con un cursor de solo avance, sin armar la lista
+     *
+     * Del más reciente al más antiguo (orden de id, servido por
+     * idx_stock_movements_product). Para auditorías y conciliaciones de
+     * productos con mucho historial.
+     * @return false si falla la consulta
+     */
+    bool forEachStockMovement(int productId, const StockMovementVisitor& visitor);
+
+    /**
+     * @brief Versión asíncrona (DatabaseWorker::readerInstance(), con ReadSnapshot)
+     */
+    QFuture<bool> forEachStockMovementAsync(int productId, StockMovementVisitor visitor);
+
     /**
      * @brief Validar SKU único
      */
@@ -113,6 +186,11 @@ private:
      */
     bool validateProduct(const Product& product, QString& errorMessage);
 
+    /**
+     * @brief Validar campos sin consultar la base (nombre, precios, stock)
+     */
+    bool validateProductFields(const Product& product, QString& errorMessage);
+
     /**
      * @brief Verificar y emitir alerta de stock bajo
      */
@@ -134,6 +212,13 @@ private:
      * @brief Obtener o crear categoría por nombre
      */
     int getOrCreateCategoryId(const QString& categoryName);
+
+    /**
+     * @brief IDs parecidos al término según CatalogIndex (sin los de exclude)
+     *
+     * Vacío si el índice aún no se cargó.
+     */
+    QList<int> fuzzyCandidates(const QString& searchTerm, const QSet<int>& exclude);
 };
 
 #endif // PRODUCTSERVICE_H
@@ -1,7 +1,10 @@
 #include "SalesService.h"
 #include "ProductService.h"
-#include "../database/DatabaseManager.h"
+#include "../database/TransactionScope.h"
+#include "../database/ReadSnapshot.h"
+#include "../database/DatabaseWorker.h"
 #include <QDebug>
+#include <utility>
 
 SalesService::SalesService(QObject *parent)
     : QObject(parent)
@@ -20,18 +23,13 @@ bool SalesService::createSale(Sale& sale, QString& errorMessage)
     
     qDebug() << "  Sale validated successfully";
 
-    // Generar número de factura si no se proporcionó
-    if (sale.invoiceNumber.isEmpty()) {
-        sale.invoiceNumber = m_saleRepo.generateNextInvoiceNumber();
-        qDebug() << "  Generated invoice number:" << sale.invoiceNumber;
-    }
-
     // Calcular totales
     sale.calculateTotals();
     qDebug() << "  Totals calculated - Total:" << sale.total;
 
-    // Iniciar transacción
-    if (!DatabaseManager::instance().beginTransaction()) {
+    // Iniciar transacción (se revierte al salir si no se confirma)
+    TransactionScope transaction;
+    if (!transaction.isActive()) {
         errorMessage = "Error iniciando transacción";
         qCritical() << "  " << errorMessage;
         return false;
@@ -39,10 +37,20 @@ bool SalesService::createSale(Sale& sale, QString& errorMessage)
     
     qDebug() << "  Transaction started";
 
+    // Número de comprobante reservado dentro de la transacción (si no se proporcionó)
+    if (sale.invoiceNumber.isEmpty()) {
+        sale.invoiceNumber = m_saleRepo.allocateInvoiceNumber(sale.invoiceSeries);
+        if (sale.invoiceNumber.isEmpty()) {
+            errorMessage = "Error generando el número de comprobante";
+            qCritical() << "  " << errorMessage;
+            return false;
+        }
+        qDebug() << "  Allocated invoice number:" << sale.invoiceNumber;
+    }
+
     // Actualizar stock de productos
     if (!updateStockForSale(sale, errorMessage)) {
         qCritical() << "  Stock update failed:" << errorMessage;
-        DatabaseManager::instance().rollback();
         return false;
     }
     
@@ -51,7 +59,6 @@ bool SalesService::createSale(Sale& sale, QString& errorMessage)
     // Crear venta
     int saleId = m_saleRepo.create(sale);
     if (saleId == 0) {
-        DatabaseManager::instance().rollback();
         errorMessage = "Error guardando la venta";
         qCritical() << "  " << errorMessage;
         return false;
@@ -60,8 +67,7 @@ bool SalesService::createSale(Sale& sale, QString& errorMessage)
     qDebug() << "  Sale saved with ID:" << saleId;
 
     // Confirmar transacción
-    if (!DatabaseManager::instance().commit()) {
-        DatabaseManager::instance().rollback();
+    if (!transaction.commit()) {
         errorMessage = "Error confirmando la venta";
         qCritical() << "  " << errorMessage;
         return false;
@@ -73,6 +79,22 @@ bool SalesService::createSale(Sale& sale, QString& errorMessage)
     return true;
 }
 
+QFuture<SalesService::SaleResult> SalesService::createSaleAsync(const Sale& sale)
+{
+    return DatabaseWorker::instance().run([sale]() {
+        SaleResult result;
+        result.sale = sale;
+        SalesService service;
+        result.success = service.createSale(result.sale, result.errorMessage);
+        return result;
+    }).then(this, [this](const SaleResult& result) {
+        if (result.success) {
+            emit saleCompleted(result.sale.id, result.sale.invoiceNumber);
+        }
+        return result;
+    });
+}
+
 bool SalesService::cancelSale(int saleId, QString& errorMessage)
 {
     // Obtener venta
@@ -88,27 +110,25 @@ bool SalesService::cancelSale(int saleId, QString& errorMessage)
     }
 
     // Iniciar transacción
-    if (!DatabaseManager::instance().beginTransaction()) {
+    TransactionScope transaction;
+    if (!transaction.isActive()) {
         errorMessage = "Error iniciando transacción";
         return false;
     }
 
     // Revertir stock
     if (!revertStockForSale(*sale, errorMessage)) {
-        DatabaseManager::instance().rollback();
         return false;
     }
 
     // Marcar venta como cancelada
     if (!m_saleRepo.cancel(saleId)) {
-        DatabaseManager::instance().rollback();
         errorMessage = "Error cancelando la venta";
         return false;
     }
 
     // Confirmar transacción
-    if (!DatabaseManager::instance().commit()) {
-        DatabaseManager::instance().rollback();
+    if (!transaction.commit()) {
         errorMessage = "Error confirmando la cancelación";
         return false;
     }
@@ -132,6 +152,23 @@ QList<Sale> SalesService::getSalesByDateRange(const QDate& from, const QDate& to
     return m_saleRepo.findByDateRange(from, to);
 }
 
+QFuture<QList<Sale>> SalesService::getSalesByDateRangeAsync(const QDate& from, const QDate& to)
+{
+    return m_saleRepo.findByDateRangeAsync(from, to);
+}
+
+bool SalesService::forEachSaleInRange(const QDate& from, const QDate& to,
+                                      const SaleRepository::SaleVisitor& visitor)
+{
+    return m_saleRepo.forEachInDateRange(from, to, visitor);
+}
+
+QFuture<bool> SalesService::forEachSaleInRangeAsync(const QDate& from, const QDate& to,
+                                                    SaleRepository::SaleVisitor visitor)
+{
+    return m_saleRepo.forEachInDateRangeAsync(from, to, std::move(visitor));
+}
+
 QList<Sale> SalesService::getTodaySales()
 {
     return m_saleRepo.findToday();
@@ -141,6 +178,9 @@ SalesService::DashboardStats SalesService::getDashboardStats()
 {
     DashboardStats stats;
 
+    // Todas las cifras del mismo punto en el tiempo, sin frenar ventas en curso
+    ReadSnapshot snapshot;
+
     // Estadísticas del día
     auto todayStats = m_saleRepo.getStatsForDate(QDate::currentDate());
     stats.todaySales = todayStats.totalSales;
@@ -158,12 +198,19 @@ SalesService::DashboardStats SalesService::getDashboardStats()
 
     // Productos con stock bajo
     ProductService productService;
-    stats.lowStockProducts = productService.getLowStockProducts().size();
-    stats.totalProducts = productService.getAllProducts(true).size();
+    stats.lowStockProducts = productService.countLowStockProducts();
+    stats.totalProducts = productService.countProducts();
 
     return stats;
 }
 
+QFuture<SalesService::DashboardStats> SalesService::getDashboardStatsAsync()
+{
+    return DatabaseWorker::readerInstance().run([]() {
+        return SalesService().getDashboardStats();
+    });
+}
+
 bool SalesService::validateSale(const Sale& sale, QString& errorMessage)
 {
     if (sale.items.isEmpty()) {
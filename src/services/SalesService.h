@@ -6,6 +6,7 @@
 #include <QObject>
 #include <QList>
 #include <QDate>
+#include <QFuture>
 
 /**
  * @brief Servicio de negocio para gestión de ventas
@@ -25,13 +26,30 @@ public:
      * 
      * Este método:
      * 1. Valida la venta y items
-     * 2. Genera número de factura
+     * 2. Reserva el número de comprobante de la serie (en la transacción)
      * 3. Crea la venta en la BD
      * 4. Actualiza stock de productos
      * 5. Registra movimientos de stock
      */
     bool createSale(Sale& sale, QString& errorMessage);
 
+    /**
+     * @brief Resultado de una venta procesada de forma asíncrona
+     */
+    struct SaleResult {
+        bool success = false;
+        Sale sale;
+        QString errorMessage;
+    };
+
+    /**
+     * @brief Versión asíncrona de createSale (se ejecuta en DatabaseWorker)
+     *
+     * La señal saleCompleted se emite en el hilo de este servicio
+     * una vez confirmada la transacción.
+     */
+    QFuture<SaleResult> createSaleAsync(const Sale& sale);
+
     /**
      * @brief Cancelar venta (revertir stock)
      */
@@ -51,6 +69,15 @@ public:
      * @brief Obtener ventas por rango de fechas
      */
     QList<Sale> getSalesByDateRange(const QDate& from, const QDate& to);
+    QFuture<QList<Sale>> getSalesByDateRangeAsync(const QDate& from, const QDate& to);
+
+    /**
+     * @brief Recorrer las ventas de un rango en memoria constante (ver SaleRepository::forEachInDateRange)
+     */
+    bool forEachSaleInRange(const QDate& from, const QDate& to,
+                            const SaleRepository::SaleVisitor& visitor);
+    QFuture<bool> forEachSaleInRangeAsync(const QDate& from, const QDate& to,
+                                          SaleRepository::SaleVisitor visitor);
 
     /**
      * @brief Obtener ventas del día
@@ -71,6 +98,11 @@ public:
 
     DashboardStats getDashboardStats();
 
+    /**
+     * @brief Versión asíncrona de getDashboardStats (se ejecuta en DatabaseWorker)
+     */
+    QFuture<DashboardStats> getDashboardStatsAsync();
+
 signals:
     /**
      * @brief Emitido cuando se completa una venta
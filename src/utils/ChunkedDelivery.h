@@ -0,0 +1,117 @@
+#ifndef CHUNKEDDELIVERY_H
+#define CHUNKEDDELIVERY_H
+
+#include <QList>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QtGlobal>
+#include <functional>
+#include <utility>
+
+/**
+ * @brief Agrupa las filas de un recorrido (forEach...) en bloques de tamaño fijo
+ *
+ * Los recorridos de los repositorios entregan una fila a la vez; este
+ * adaptador las junta en bloques de chunkSize y se los pasa al consumidor.
+ * Sin pool, el consumidor corre en el mismo hilo del recorrido. Con pool,
+ * cada bloque se procesa en un hilo del pool y como mucho maxInFlight
+ * bloques están en memoria a la vez: si los hilos no dan abasto, el
+ * recorrido espera (la memoria no crece con el tamaño del resultado).
+ *
+ * Uso:
+ * @code
+ * ChunkedDelivery<Sale> delivery(500, [](const QList<Sale>& chunk) {
+ *     ...  // Corre en QThreadPool: debe ser seguro entre hilos
+ * }, QThreadPool::globalInstance());
+ *
+ * repo.forEachInDateRange(from, to, delivery.visitor());
+ * delivery.finish();  // Último bloque y espera a que terminen todos
+ * @endcode
+ *
+ * El destructor también llama a finish(), así que no quedan trabajos en el
+ * pool que usen el objeto ya destruido.
+ */
+template <typename Row>
+class ChunkedDelivery
+{
+public:
+    using Consumer = std::function<void(const QList<Row>&)>;
+
+    ChunkedDelivery(int chunkSize, Consumer consumer,
+                    QThreadPool* pool = nullptr, int maxInFlight = 2)
+        : m_chunkSize(qMax(1, chunkSize))
+        , m_maxInFlight(qMax(1, maxInFlight))
+        , m_consumer(std::move(consumer))
+        , m_pool(pool)
+        , m_slots(m_maxInFlight)
+    {
+        m_chunk.reserve(m_chunkSize);
+    }
+
+    ~ChunkedDelivery() { finish(); }
+
+    ChunkedDelivery(const ChunkedDelivery&) = delete;
+    ChunkedDelivery& operator=(const ChunkedDelivery&) = delete;
+
+    /**
+     * @brief Agregar una fila; entrega el bloque cuando se completa
+     * @return Siempre true (el recorrido continúa)
+     */
+    bool add(const Row& row)
+    {
+        m_chunk.append(row);
+        if (m_chunk.size() >= m_chunkSize) {
+            deliver();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Visitor para pasar a los métodos forEach... (referencia a este objeto)
+     */
+    std::function<bool(const Row&)> visitor()
+    {
+        return [this](const Row& row) { return add(row); };
+    }
+
+    /**
+     * @brief Entregar el bloque incompleto y esperar a los que están en el pool
+     */
+    void finish()
+    {
+        if (!m_chunk.isEmpty()) {
+            deliver();
+        }
+        if (m_pool) {
+            m_slots.acquire(m_maxInFlight);
+            m_slots.release(m_maxInFlight);
+        }
+    }
+
+private:
+    void deliver()
+    {
+        QList<Row> chunk = std::exchange(m_chunk, QList<Row>());
+        m_chunk.reserve(m_chunkSize);
+
+        if (!m_pool) {
+            m_consumer(chunk);
+            return;
+        }
+
+        m_slots.acquire();
+        m_pool->start([this, chunk = std::move(chunk)]() {
+            m_consumer(chunk);
+            m_slots.release();
+        });
+    }
+
+    const int m_chunkSize;
+    const int m_maxInFlight;
+    const Consumer m_consumer;
+    QThreadPool* m_pool;
+    QSemaphore m_slots;  // Bloques que todavía pueden enviarse al pool
+    QList<Row> m_chunk;
+};
+
+#endif // CHUNKEDDELIVERY_H
@@ -0,0 +1,193 @@
+#ifndef OPENADDRESSINGMAP_H
+#define OPENADDRESSINGMAP_H
+
+#include <QHashFunctions>
+#include <QtGlobal>
+#include <vector>
+#include <utility>
+
+/**
+ * @brief Tabla hash de direccionamiento abierto (sondeo lineal)
+ *
+ * Guarda las entradas en un único arreglo contiguo, sin un nodo por
+ * elemento como QHash/std::unordered_map: una búsqueda suele resolverse
+ * en una o dos líneas de caché. Pensada para índices residentes que se
+ * consultan mucho y cambian poco (ver CatalogIndex).
+ *
+ * - Capacidad potencia de dos; crece al superar 70% de ocupación
+ *   (contando las lápidas de los elementos eliminados)
+ * - Se guarda el hash de cada clave para comparar claves solo si coincide
+ * - Key necesita qHash() y operator==
+ *
+ * No es thread-safe: el dueño debe sincronizar el acceso.
+ */
+template <typename Key, typename Value>
+class OpenAddressingMap
+{
+public:
+    OpenAddressingMap() = default;
+
+    /**
+     * @brief Buscar una clave
+     * @return Puntero al valor, o nullptr si no existe
+     */
+    const Value* find(const Key& key) const
+    {
+        if (m_slots.empty()) {
+            return nullptr;
+        }
+
+        const size_t hash = hashOf(key);
+        for (size_t i = hash & m_mask;; i = (i + 1) & m_mask) {
+            const Slot& slot = m_slots[i];
+            if (slot.state == Empty) {
+                return nullptr;
+            }
+            if (slot.state == Used && slot.hash == hash && slot.key == key) {
+                return &slot.value;
+            }
+        }
+    }
+
+    bool contains(const Key& key) const { return find(key) != nullptr; }
+
+    /**
+     * @brief Insertar o reemplazar el valor de una clave
+     */
+    void insert(const Key& key, const Value& value)
+    {
+        if ((m_used + m_tombstones + 1) * 10 > m_slots.size() * 7) {
+            rehash((m_used + 1) * 2);
+        }
+
+        const size_t hash = hashOf(key);
+        size_t target = m_slots.size();  // Primera lápida encontrada
+        for (size_t i = hash & m_mask;; i = (i + 1) & m_mask) {
+            Slot& slot = m_slots[i];
+            if (slot.state == Empty) {
+                if (target == m_slots.size()) {
+                    target = i;
+                }
+                break;
+            }
+            if (slot.state == Deleted) {
+                if (target == m_slots.size()) {
+                    target = i;
+                }
+                continue;
+            }
+            if (slot.hash == hash && slot.key == key) {
+                slot.value = value;
+                return;
+            }
+        }
+
+        Slot& slot = m_slots[target];
+        if (slot.state == Deleted) {
+            --m_tombstones;
+        }
+        slot.state = Used;
+        slot.hash = hash;
+        slot.key = key;
+        slot.value = value;
+        ++m_used;
+    }
+
+    /**
+     * @brief Eliminar una clave
+     * @return false si no existía
+     */
+    bool remove(const Key& key)
+    {
+        if (m_slots.empty()) {
+            return false;
+        }
+
+        const size_t hash = hashOf(key);
+        for (size_t i = hash & m_mask;; i = (i + 1) & m_mask) {
+            Slot& slot = m_slots[i];
+            if (slot.state == Empty) {
+                return false;
+            }
+            if (slot.state == Used && slot.hash == hash && slot.key == key) {
+                // Lápida: la cadena de sondeo de otras claves sigue intacta
+                slot.state = Deleted;
+                slot.key = Key();
+                slot.value = Value();
+                --m_used;
+                ++m_tombstones;
+                return true;
+            }
+        }
+    }
+
+    /**
+     * @brief Reservar espacio para n elementos sin rehash intermedios
+     */
+    void reserve(size_t count)
+    {
+        if (count * 10 > m_slots.size() * 7) {
+            rehash(count);
+        }
+    }
+
+    void clear()
+    {
+        m_slots.clear();
+        m_mask = 0;
+        m_used = 0;
+        m_tombstones = 0;
+    }
+
+    size_t size() const { return m_used; }
+    bool isEmpty() const { return m_used == 0; }
+
+private:
+    enum State : quint8 { Empty, Used, Deleted };
+
+    struct Slot {
+        size_t hash = 0;
+        Key key = Key();
+        Value value = Value();
+        State state = Empty;
+    };
+
+    static size_t hashOf(const Key& key)
+    {
+        return qHash(key, 0);
+    }
+
+    void rehash(size_t minimumCount)
+    {
+        size_t capacity = 16;
+        while (minimumCount * 10 > capacity * 7) {
+            capacity *= 2;
+        }
+
+        std::vector<Slot> old = std::move(m_slots);
+        m_slots.assign(capacity, Slot());
+        m_mask = capacity - 1;
+        m_used = 0;
+        m_tombstones = 0;
+
+        for (Slot& slot : old) {
+            if (slot.state != Used) {
+                continue;
+            }
+            for (size_t i = slot.hash & m_mask;; i = (i + 1) & m_mask) {
+                if (m_slots[i].state == Empty) {
+                    m_slots[i] = std::move(slot);
+                    ++m_used;
+                    break;
+                }
+            }
+        }
+    }
+
+    std::vector<Slot> m_slots;
+    size_t m_mask = 0;
+    size_t m_used = 0;
+    size_t m_tombstones = 0;
+};
+
+#endif // OPENADDRESSINGMAP_H
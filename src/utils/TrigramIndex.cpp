@@ -0,0 +1,161 @@
+#include "TrigramIndex.h"
+#include <QStringList>
+#include <algorithm>
+
+QString TrigramIndex::normalize(const QString& text)
+{
+    // NFD separa "á" en "a" + tilde combinante, que se descarta
+    const QString decomposed = text.normalized(QString::NormalizationForm_D).toLower();
+
+    QString result;
+    result.reserve(decomposed.size());
+    bool pendingSpace = false;
+
+    for (const QChar ch : decomposed) {
+        if (ch.category() == QChar::Mark_NonSpacing) {
+            continue;
+        }
+        if (ch.isLetterOrNumber()) {
+            if (pendingSpace && !result.isEmpty()) {
+                result.append(' ');
+            }
+            pendingSpace = false;
+            result.append(ch);
+        } else {
+            pendingSpace = true;
+        }
+    }
+
+    return result;
+}
+
+std::vector<quint64> TrigramIndex::trigramsOf(const QString& text)
+{
+    std::vector<quint64> trigrams;
+
+    const QStringList words = normalize(text).split(' ', Qt::SkipEmptyParts);
+    for (const QString& word : words) {
+        const QString padded = "  " + word + ' ';
+        for (int i = 0; i + 3 <= padded.size(); ++i) {
+            trigrams.push_back((quint64(padded.at(i).unicode()) << 32)
+                               | (quint64(padded.at(i + 1).unicode()) << 16)
+                               | quint64(padded.at(i + 2).unicode()));
+        }
+    }
+
+    // Cada trigrama cuenta una vez por entrada
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+void TrigramIndex::insert(int slot, const QString& text)
+{
+    remove(slot);
+
+    if (slot >= static_cast<int>(m_slotTrigrams.size())) {
+        m_slotTrigrams.resize(slot + 1);
+    }
+
+    std::vector<quint64> trigrams = trigramsOf(text);
+    for (quint64 trigram : trigrams) {
+        const int* id = m_trigramIds.find(trigram);
+        if (id) {
+            m_postings[*id].push_back(slot);
+        } else {
+            m_trigramIds.insert(trigram, static_cast<int>(m_postings.size()));
+            m_postings.push_back({slot});
+        }
+    }
+
+    m_slotTrigrams[slot] = std::move(trigrams);
+}
+
+void TrigramIndex::remove(int slot)
+{
+    if (slot >= static_cast<int>(m_slotTrigrams.size())) {
+        return;
+    }
+
+    for (quint64 trigram : m_slotTrigrams[slot]) {
+        const int* id = m_trigramIds.find(trigram);
+        if (!id) {
+            continue;
+        }
+        // El orden de las listas no importa: quitar intercambiando con el último
+        std::vector<int>& posting = m_postings[*id];
+        auto it = std::find(posting.begin(), posting.end(), slot);
+        if (it != posting.end()) {
+            *it = posting.back();
+            posting.pop_back();
+        }
+    }
+
+    m_slotTrigrams[slot].clear();
+}
+
+QList<TrigramIndex::Match> TrigramIndex::search(const QString& text, int limit, double minScore) const
+{
+    QList<Match> matches;
+
+    const std::vector<quint64> query = trigramsOf(text);
+    if (query.empty() || limit <= 0) {
+        return matches;
+    }
+
+    // Contar trigramas en común recorriendo solo las listas de la consulta
+    std::vector<quint16> shared(m_slotTrigrams.size(), 0);
+    std::vector<int> candidates;
+
+    for (quint64 trigram : query) {
+        const int* id = m_trigramIds.find(trigram);
+        if (!id) {
+            continue;
+        }
+        for (int slot : m_postings[*id]) {
+            if (shared[slot]++ == 0) {
+                candidates.push_back(slot);
+            }
+        }
+    }
+
+    const double queryCount = static_cast<double>(query.size());
+    struct Ranked {
+        int slot;
+        double score;
+        double similarity;  // Jaccard: desempata a favor de nombres más cortos
+    };
+    std::vector<Ranked> ranked;
+
+    for (int slot : candidates) {
+        const double common = shared[slot];
+        const double score = common / queryCount;
+        if (score < minScore || common < 2) {
+            continue;
+        }
+        const double total = queryCount + m_slotTrigrams[slot].size() - common;
+        ranked.push_back({slot, score, common / total});
+    }
+
+    const size_t count = std::min<size_t>(ranked.size(), static_cast<size_t>(limit));
+    std::partial_sort(ranked.begin(), ranked.begin() + count, ranked.end(),
+                      [](const Ranked& a, const Ranked& b) {
+                          if (a.score != b.score) {
+                              return a.score > b.score;
+                          }
+                          return a.similarity > b.similarity;
+                      });
+
+    matches.reserve(static_cast<int>(count));
+    for (size_t i = 0; i < count; ++i) {
+        matches.append({ranked[i].slot, ranked[i].score});
+    }
+    return matches;
+}
+
+void TrigramIndex::clear()
+{
+    m_trigramIds.clear();
+    m_postings.clear();
+    m_slotTrigrams.clear();
+}
@@ -0,0 +1,66 @@
+#ifndef TRIGRAMINDEX_H
+#define TRIGRAMINDEX_H
+
+#include "OpenAddressingMap.h"
+#include <QString>
+#include <QList>
+#include <vector>
+
+/**
+ * @brief Índice de trigramas para búsqueda aproximada (tolerante a errores)
+ *
+ * Cada texto se normaliza (minúsculas, sin tildes ni signos) y se parte en
+ * trigramas por palabra, con relleno al inicio y al final como pg_trgm:
+ * "teclado" -> "  t", " te", "tec", "ecl", "cla", "lad", "ado", "do ".
+ * "teclao" comparte 5 de sus 7 trigramas con "teclado", así que lo encuentra.
+ *
+ * Las entradas se identifican por un entero denso (posición en el arreglo
+ * del dueño) y se agregan o quitan de a una, sin reconstruir el índice.
+ *
+ * No es thread-safe: el dueño debe sincronizar el acceso (ver CatalogIndex).
+ */
+class TrigramIndex
+{
+public:
+    struct Match {
+        int slot = 0;
+        double score = 0.0;  // Fracción de trigramas de la consulta presentes (0-1)
+    };
+
+    /**
+     * @brief Normalizar para comparar: minúsculas, sin tildes, solo letras y dígitos
+     *
+     * "Teclado Mecánico" -> "teclado mecanico"; la ñ se compara como n.
+     */
+    static QString normalize(const QString& text);
+
+    /**
+     * @brief Indexar el texto de una entrada (reemplaza el anterior)
+     */
+    void insert(int slot, const QString& text);
+
+    /**
+     * @brief Quitar una entrada
+     */
+    void remove(int slot);
+
+    /**
+     * @brief Entradas más parecidas al texto, de mayor a menor puntaje
+     * @param minScore Fracción mínima de trigramas de la consulta en común
+     */
+    QList<Match> search(const QString& text, int limit, double minScore = 0.5) const;
+
+    void clear();
+
+private:
+    static std::vector<quint64> trigramsOf(const QString& text);
+
+    // Trigrama -> posición en m_postings
+    OpenAddressingMap<quint64, int> m_trigramIds;
+    std::vector<std::vector<int>> m_postings;
+
+    // Trigramas de cada entrada (para quitarla y para desempatar por largo)
+    std::vector<std::vector<quint64>> m_slotTrigrams;
+};
+
+#endif // TRIGRAMINDEX_H
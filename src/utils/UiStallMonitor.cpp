@@ -0,0 +1,88 @@
+#include "UiStallMonitor.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <QTimer>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// Intervalo del latido: un cuadro a 60 Hz
+constexpr int kHeartbeatMs = 16;
+}
+
+UiStallMonitor& UiStallMonitor::instance()
+{
+    static UiStallMonitor instance;
+    return instance;
+}
+
+UiStallMonitor::UiStallMonitor(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void UiStallMonitor::start(int thresholdMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_thresholdMs = std::max(1, thresholdMs);
+    if (m_heartbeat) {
+        return;
+    }
+
+    m_uiThread = QThread::currentThread();
+    m_clock.start();
+    m_lastBeatNs = 0;
+
+    // Vive en el hilo de UI y se destruye con la aplicación
+    m_heartbeat = new QTimer(QCoreApplication::instance());
+    m_heartbeat->setTimerType(Qt::PreciseTimer);
+    m_heartbeat->setInterval(kHeartbeatMs);
+    connect(m_heartbeat, &QTimer::timeout, m_heartbeat, [this]() { checkHeartbeat(); });
+    m_heartbeat->start();
+
+    qDebug() << "Monitor de bloqueos de UI activo (umbral" << m_thresholdMs << "ms)";
+}
+
+void UiStallMonitor::checkHeartbeat()
+{
+    qint64 stallNs = 0;
+    {
+        QMutexLocker locker(&m_mutex);
+
+        const qint64 nowNs = m_clock.nsecsElapsed();
+        const qint64 lateNs = nowNs - m_lastBeatNs - kHeartbeatMs * 1000000LL;
+        m_lastBeatNs = nowNs;
+
+        if (lateNs >= m_thresholdMs * 1000000LL) {
+            stallNs = lateNs;
+            m_stats.stalls++;
+            m_stats.totalNs += stallNs;
+            m_stats.maxNs = std::max(m_stats.maxNs, stallNs);
+        }
+    }
+
+    if (stallNs > 0) {
+        qWarning() << "Bloqueo de UI:" << stallNs / 1e6 << "ms";
+        emit stallDetected(stallNs / 1e6);
+    }
+
+    m_beat.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool UiStallMonitor::isUiThread() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_uiThread && QThread::currentThread() == m_uiThread;
+}
+
+int UiStallMonitor::thresholdMs() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_thresholdMs;
+}
+
+UiStallMonitor::Stats UiStallMonitor::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stats;
+}
@@ -0,0 +1,83 @@
+#ifndef UISTALLMONITOR_H
+#define UISTALLMONITOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <atomic>
+
+class QThread;
+class QTimer;
+
+/**
+ * @brief Medición de bloqueos del hilo de UI (Singleton)
+ *
+ * Un temporizador de un cuadro (16 ms) en el hilo de UI mide cuánto se
+ * atrasa el bucle de eventos. Un atraso de thresholdMs o más es un bloqueo:
+ * cuadros que QML no pudo actualizar.
+ */
+class UiStallMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Bloqueos acumulados desde start()
+     */
+    struct Stats {
+        quint64 stalls = 0;
+        qint64 totalNs = 0;
+        qint64 maxNs = 0;
+    };
+
+    static UiStallMonitor& instance();
+
+    /**
+     * @brief Empezar a medir
+     *
+     * Debe llamarse desde el hilo de UI con la aplicación ya creada.
+     */
+    void start(int thresholdMs = 50);
+
+    /**
+     * @brief Verdadero si se llama desde el hilo medido
+     */
+    bool isUiThread() const;
+
+    /**
+     * @brief Número de latidos transcurridos
+     *
+     * Cambia en cada latido; permite agrupar lo ocurrido en el hilo de UI
+     * entre dos latidos consecutivos.
+     */
+    quint64 beat() const { return m_beat.load(std::memory_order_relaxed); }
+
+    int thresholdMs() const;
+    Stats stats() const;
+
+signals:
+    /**
+     * @brief Emitida en el hilo de UI al terminar un bloqueo, antes de
+     *        avanzar beat()
+     */
+    void stallDetected(double stallMs);
+
+private:
+    explicit UiStallMonitor(QObject *parent = nullptr);
+
+    /**
+     * @brief Latido del temporizador: detectar un bloqueo
+     */
+    void checkHeartbeat();
+
+    QThread* m_uiThread = nullptr;
+    QTimer* m_heartbeat = nullptr;
+    QElapsedTimer m_clock;
+    qint64 m_lastBeatNs = 0;
+    int m_thresholdMs = 50;
+    std::atomic<quint64> m_beat{0};
+    Stats m_stats;
+    mutable QMutex m_mutex;
+};
+
+#endif // UISTALLMONITOR_H
@@ -13,9 +13,19 @@ void DashboardViewModel::refresh()
 {
     setIsLoading(true);
 
+    // Las consultas corren en el hilo de base de datos; la UI sigue respondiendo
     SalesService salesService;
-    auto stats = salesService.getDashboardStats();
+    salesService.getDashboardStatsAsync().then(this, [this](const SalesService::DashboardStats& stats) {
+        applyStats(stats);
+        setIsLoading(false);
+    }).onCanceled(this, [this]() {
+        // El hilo de lectura descartó la tarea al cerrar
+        setIsLoading(false);
+    });
+}
 
+void DashboardViewModel::applyStats(const SalesService::DashboardStats& stats)
+{
     m_todaySales = stats.todaySales;
     m_todayTransactions = stats.todayTransactions;
     m_monthSales = stats.monthSales;
@@ -29,8 +39,6 @@ void DashboardViewModel::refresh()
     emit averageTicketChanged();
     emit lowStockProductsChanged();
     emit totalProductsChanged();
-
-    setIsLoading(false);
 }
 
 void DashboardViewModel::setIsLoading(bool loading)
@@ -1,6 +1,7 @@
 #ifndef DASHBOARDVIEWMODEL_H
 #define DASHBOARDVIEWMODEL_H
 
+#include "../services/SalesService.h"
 #include <QObject>
 #include <qqml.h>
 
@@ -61,6 +62,7 @@ private:
     bool m_isLoading = false;
 
     void setIsLoading(bool loading);
+    void applyStats(const SalesService::DashboardStats& stats);
 };
 
 #endif // DASHBOARDVIEWMODEL_H
@@ -18,7 +18,7 @@ QVariant ProductListModel::data(const QModelIndex &index, int role) const
     if (!index.isValid() || index.row() >= m_products.count())
         return QVariant();
 
-    const Product& product = m_products.at(index.row());
+    const ProductSummary& product = m_products.at(index.row());
 
     switch (role) {
     case IdRole:
@@ -39,8 +39,6 @@ QVariant ProductListModel::data(const QModelIndex &index, int role) const
         return product.purchasePrice;
     case SalePriceRole:
         return product.salePrice;
-    case DescriptionRole:
-        return product.description;
     case ActiveRole:
         return product.active;
     case IsLowStockRole:
@@ -62,7 +60,6 @@ QHash<int, QByteArray> ProductListModel::roleNames() const
     roles[MinimumStockRole] = "minimumStock";
     roles[PurchasePriceRole] = "purchasePrice";
     roles[SalePriceRole] = "salePrice";
-    roles[DescriptionRole] = "description";
     roles[ActiveRole] = "active";
     roles[IsLowStockRole] = "isLowStock";
     return roles;
@@ -70,40 +67,100 @@ QHash<int, QByteArray> ProductListModel::roleNames() const
 
 void ProductListModel::loadProducts()
 {
-    setIsLoading(true);
+    loadFirstPage(ProductRepository::PageFilters());
+}
+
+void ProductListModel::loadFirstPage(const ProductRepository::PageFilters& filters)
+{
+    // Solo la primera página; el resto llega con fetchMore() al desplazarse
+    const int request = beginLoad(ListMode::Paged);
+    m_pageFilters = filters;
+    m_hasMore = false;
 
     ProductService service;
-    auto products = service.getAllProducts(true);
+    service.getProductPageAsync(QString(), 0, kPageSize, filters)
+        .then(this, [this, request](const QList<ProductSummary>& products) {
+            if (request == m_loadRequest) {
+                m_hasMore = products.size() == kPageSize;
+            }
+            applyProducts(request, products);
+        });
+}
 
-    beginResetModel();
-    m_products = products;
-    endResetModel();
+bool ProductListModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && m_hasMore && !m_fetchingMore && !m_isLoading;
+}
 
-    emit countChanged();
-    setIsLoading(false);
+void ProductListModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent) || m_products.isEmpty()) {
+        return;
+    }
+
+    m_fetchingMore = true;
+    const int request = m_loadRequest;
+    const ProductSummary& last = m_products.constLast();
+
+    ProductService service;
+    service.getProductPageAsync(last.name, last.id, kPageSize, m_pageFilters)
+        .then(this, [this, request](const QList<ProductSummary>& products) {
+            m_fetchingMore = false;
+            if (request != m_loadRequest) {
+                return;  // La lista se recargó mientras tanto
+            }
+
+            m_hasMore = products.size() == kPageSize;
+            if (products.isEmpty()) {
+                return;
+            }
+
+            beginInsertRows(QModelIndex(), m_products.size(), m_products.size() + products.size() - 1);
+            m_products.append(products);
+            endInsertRows();
+
+            emit countChanged();
+        });
 }
 
 void ProductListModel::searchProducts(const QString& searchTerm)
 {
-    setIsLoading(true);
-
+    const int request = beginLoad(ListMode::Search);
+    m_hasMore = false;  // La búsqueda ya devuelve los resultados más relevantes
     ProductService service;
-    auto products = service.searchProducts(searchTerm);
+    service.searchProductSummariesAsync(searchTerm)
+        .then(this, [this, request](const QList<ProductSummary>& products) {
+            applyProducts(request, products);
+        });
+}
 
-    beginResetModel();
-    m_products = products;
-    endResetModel();
+void ProductListModel::filterByCategory(int categoryId)
+{
+    ProductRepository::PageFilters filters;
+    filters.categoryId = categoryId;
+    loadFirstPage(filters);
+}
 
-    emit countChanged();
-    setIsLoading(false);
+void ProductListModel::filterByCategoryName(const QString& categoryName)
+{
+    if (categoryName.isEmpty() || categoryName == "Todas") {
+        // Si no hay categoría o es "Todas", cargar todos los productos
+        loadProducts();
+        return;
+    }
+
+    ProductRepository::PageFilters filters;
+    filters.categoryName = categoryName;
+    loadFirstPage(filters);
 }
 
-void ProductListModel::filterByCategory(int categoryId)
+void ProductListModel::filterLowStock()
 {
-    setIsLoading(true);
+    beginLoad(ListMode::LowStock);
+    m_hasMore = false;
 
     ProductService service;
-    auto products = service.getProductsByCategory(categoryId);
+    auto products = service.getLowStockProductSummaries();
 
     beginResetModel();
     m_products = products;
@@ -113,48 +170,138 @@ void ProductListModel::filterByCategory(int categoryId)
     setIsLoading(false);
 }
 
-void ProductListModel::filterByCategoryName(const QString& categoryName)
+void ProductListModel::syncChanges()
 {
-    setIsLoading(true);
-
-    if (categoryName.isEmpty() || categoryName == "Todas") {
-        // Si no hay categoría o es "Todas", cargar todos los productos
-        loadProducts();
+    if (m_syncing) {
+        m_syncQueued = true;  // Se repite al terminar la sincronización en curso
         return;
     }
 
+    m_syncing = true;
+    const int request = m_loadRequest;
+
     ProductService service;
-    auto allProducts = service.getAllProducts(true);
-    
-    // Filtrar por nombre de categoría
-    QList<Product> filteredProducts;
-    for (const auto& product : allProducts) {
-        if (product.categoryName.compare(categoryName, Qt::CaseInsensitive) == 0) {
-            filteredProducts.append(product);
+    service.getProductChangesAsync(m_syncVersion)
+        .then(this, [this, request](const ProductRepository::ChangeSet& changes) {
+            m_syncing = false;
+
+            // Si la lista se recargó, ya refleja esos cambios
+            if (request == m_loadRequest) {
+                applyChanges(changes);
+            }
+
+            if (m_syncQueued) {
+                m_syncQueued = false;
+                syncChanges();
+            }
+        });
+}
+
+void ProductListModel::applyChanges(const ProductRepository::ChangeSet& changes)
+{
+    m_syncVersion = qMax(m_syncVersion, changes.version);
+    const int previousCount = m_products.size();
+
+    for (int productId : changes.deleted) {
+        const int row = rowOfProduct(productId);
+        if (row >= 0) {
+            beginRemoveRows(QModelIndex(), row, row);
+            m_products.removeAt(row);
+            endRemoveRows();
         }
     }
 
-    beginResetModel();
-    m_products = filteredProducts;
-    endResetModel();
+    for (const ProductSummary& product : changes.changed) {
+        const int row = rowOfProduct(product.id);
+        const bool visible = isVisibleInList(product);
+
+        if (row >= 0) {
+            const bool samePosition =
+                (row == 0 || !isOrderedBefore(product, m_products.at(row - 1)))
+                && (row == m_products.size() - 1 || !isOrderedBefore(m_products.at(row + 1), product));
+
+            if (visible && samePosition) {
+                m_products[row] = product;
+                emit dataChanged(index(row), index(row));
+                continue;
+            }
+
+            // Ya no corresponde a la lista o cambió su posición en el orden
+            beginRemoveRows(QModelIndex(), row, row);
+            m_products.removeAt(row);
+            endRemoveRows();
+        }
 
-    emit countChanged();
-    setIsLoading(false);
+        // Las búsquedas no se completan con productos nuevos: su criterio
+        // (relevancia FTS5) no se puede evaluar aquí
+        if (!visible || m_mode == ListMode::Search) {
+            continue;
+        }
+
+        int position = 0;
+        while (position < m_products.size() && isOrderedBefore(m_products.at(position), product)) {
+            ++position;
+        }
+
+        // Después de la última fila cargada: llegará con fetchMore()
+        if (position == m_products.size() && m_hasMore) {
+            continue;
+        }
+
+        beginInsertRows(QModelIndex(), position, position);
+        m_products.insert(position, product);
+        endInsertRows();
+    }
+
+    if (m_products.size() != previousCount) {
+        emit countChanged();
+    }
 }
 
-void ProductListModel::filterLowStock()
+bool ProductListModel::isVisibleInList(const ProductSummary& product) const
 {
-    setIsLoading(true);
+    switch (m_mode) {
+    case ListMode::LowStock:
+        return product.active && product.isLowStock();
+    case ListMode::Search:
+        return product.active;
+    case ListMode::Paged:
+        break;
+    }
 
-    ProductService service;
-    auto products = service.getLowStockProducts();
+    if (m_pageFilters.activeOnly && !product.active) {
+        return false;
+    }
+    if (m_pageFilters.categoryId > 0 && product.categoryId != m_pageFilters.categoryId) {
+        return false;
+    }
+    if (!m_pageFilters.categoryName.isEmpty()
+        && product.categoryName.compare(m_pageFilters.categoryName, Qt::CaseInsensitive) != 0) {
+        return false;
+    }
+    return true;
+}
 
-    beginResetModel();
-    m_products = products;
-    endResetModel();
+bool ProductListModel::isOrderedBefore(const ProductSummary& a, const ProductSummary& b) const
+{
+    if (m_mode == ListMode::LowStock) {
+        // Mismo orden que findLowStock(): por stock ascendente
+        return a.currentStock < b.currentStock;
+    }
 
-    emit countChanged();
-    setIsLoading(false);
+    // Mismo orden que el cursor de findPage(): (nombre, id)
+    const int byName = a.name.compare(b.name);
+    return byName < 0 || (byName == 0 && a.id < b.id);
+}
+
+int ProductListModel::rowOfProduct(int productId) const
+{
+    for (int row = 0; row < m_products.size(); ++row) {
+        if (m_products.at(row).id == productId) {
+            return row;
+        }
+    }
+    return -1;
 }
 
 QVariantMap ProductListModel::getProduct(int index) const
@@ -162,7 +309,7 @@ QVariantMap ProductListModel::getProduct(int index) const
     if (index < 0 || index >= m_products.count())
         return QVariantMap();
 
-    return productToVariantMap(m_products.at(index));
+    return summaryToVariantMap(m_products.at(index));
 }
 
 bool ProductListModel::addProduct(const QVariantMap& productData)
@@ -191,7 +338,7 @@ bool ProductListModel::addProduct(const QVariantMap& productData)
     product.active = true;
 
     if (service.createProduct(product, errorMessage)) {
-        loadProducts();
+        syncChanges();
         emit productAdded(product.id);
         emit operationSucceeded("Producto creado exitosamente");
         return true;
@@ -246,7 +393,7 @@ bool ProductListModel::updateProduct(int productId, const QVariantMap& productDa
     currentProduct->description = productData.value("description", currentProduct->description).toString().trimmed();
 
     if (service.updateProduct(*currentProduct, errorMessage)) {
-        loadProducts();
+        syncChanges();
         emit productUpdated(productId);
         emit operationSucceeded("Producto actualizado exitosamente");
         qDebug() << "Producto actualizado correctamente. ID:" << productId;
@@ -264,8 +411,8 @@ bool ProductListModel::deleteProduct(int productId)
     QString errorMessage;
 
     if (service.deleteProduct(productId, errorMessage)) {
-        // Recargar lista
-        loadProducts();
+        // Quitar de la lista sin recargarla
+        syncChanges();
         emit productDeleted(productId);
         emit operationSucceeded("Producto eliminado exitosamente");
         return true;
@@ -308,14 +455,7 @@ QString ProductListModel::validateProductData(const QVariantMap& productData) co
 
 QVariantMap ProductListModel::getProductForEdit(int productId) const
 {
-    // Buscar producto por ID en la lista actual
-    for (const auto& product : m_products) {
-        if (product.id == productId) {
-            return productToVariantMap(product);
-        }
-    }
-
-    // Si no está en caché, consultar desde el servicio
+    // La lista solo tiene la proyección liviana: cargar el producto completo
     ProductService service;
     auto product = service.getProduct(productId);
     if (product) {
@@ -326,6 +466,33 @@ QVariantMap ProductListModel::getProductForEdit(int productId) const
     return QVariantMap();
 }
 
+void ProductListModel::applyProducts(int request, const QList<ProductSummary>& products)
+{
+    if (request != m_loadRequest) {
+        return;  // Resultado de una carga ya reemplazada por otra
+    }
+
+    beginResetModel();
+    m_products = products;
+    endResetModel();
+
+    emit countChanged();
+    setIsLoading(false);
+}
+
+int ProductListModel::beginLoad(ListMode mode)
+{
+    setIsLoading(true);
+    m_mode = mode;
+
+    // Versión tomada antes de leer: lo que cambie durante la carga se
+    // vuelve a aplicar en el próximo syncChanges() (aplicar es idempotente)
+    ProductService service;
+    m_syncVersion = service.currentProductVersion();
+
+    return ++m_loadRequest;
+}
+
 void ProductListModel::setIsLoading(bool loading)
 {
     if (m_isLoading != loading) {
@@ -334,6 +501,24 @@ void ProductListModel::setIsLoading(bool loading)
     }
 }
 
+QVariantMap ProductListModel::summaryToVariantMap(const ProductSummary& product) const
+{
+    QVariantMap map;
+    map["id"] = product.id;
+    map["name"] = product.name;
+    map["sku"] = product.sku;
+    map["barcode"] = product.barcode;
+    map["categoryId"] = product.categoryId;
+    map["category"] = product.categoryName;
+    map["currentStock"] = product.currentStock;
+    map["minimumStock"] = product.minimumStock;
+    map["purchasePrice"] = product.purchasePrice;
+    map["salePrice"] = product.salePrice;
+    map["active"] = product.active;
+    map["isLowStock"] = product.isLowStock();
+    return map;
+}
+
 QVariantMap ProductListModel::productToVariantMap(const Product& product) const
 {
     QVariantMap map;
@@ -2,6 +2,8 @@
 #define PRODUCTLISTMODEL_H
 
 #include "../models/Product.h"
+#include "../models/ProductSummary.h"
+#include "../repositories/ProductRepository.h"
 #include <QAbstractListModel>
 #include <QList>
 #include <qqml.h>
@@ -31,7 +33,6 @@ public:
         MinimumStockRole,
         PurchasePriceRole,
         SalePriceRole,
-        DescriptionRole,
         ActiveRole,
         IsLowStockRole
     };
@@ -43,11 +44,17 @@ public:
     QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
     QHash<int, QByteArray> roleNames() const override;
 
+    /**
+     * @brief Paginación: ListView pide la página siguiente al llegar al final
+     */
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
     bool isLoading() const { return m_isLoading; }
 
 public slots:
     /**
-     * @brief Cargar todos los productos
+     * @brief Cargar la primera página de productos activos
      */
     void loadProducts();
 
@@ -71,6 +78,16 @@ public slots:
      */
     void filterLowStock();
 
+    /**
+     * @brief Aplicar los cambios de productos hechos desde la última carga
+     *
+     * Pide a ProductService solo los productos modificados desde la versión
+     * sincronizada y actualiza, inserta o quita esas filas, sin recargar
+     * la lista. Se llama tras agregar, editar o eliminar; también puede
+     * llamarse periódicamente para ver cambios de otras pantallas.
+     */
+    Q_INVOKABLE void syncChanges();
+
     /**
      * @brief Obtener producto por índice
      */
@@ -111,10 +128,32 @@ signals:
     void operationSucceeded(const QString& message);
 
 private:
-    QList<Product> m_products;
+    QList<ProductSummary> m_products;  // Proyección liviana; la edición carga el Product
     bool m_isLoading = false;
+    int m_loadRequest = 0;  // Identifica la carga asíncrona más reciente
+
+    // Listado paginado por cursor (loadProducts y filtros por categoría)
+    static constexpr int kPageSize = 100;
+    ProductRepository::PageFilters m_pageFilters;
+    bool m_hasMore = false;
+    bool m_fetchingMore = false;
+
+    // Sincronización incremental (ver syncChanges)
+    enum class ListMode { Paged, Search, LowStock };
+    ListMode m_mode = ListMode::Paged;
+    qint64 m_syncVersion = 0;
+    bool m_syncing = false;
+    bool m_syncQueued = false;
 
     void setIsLoading(bool loading);
+    int beginLoad(ListMode mode);
+    void applyChanges(const ProductRepository::ChangeSet& changes);
+    bool isVisibleInList(const ProductSummary& product) const;
+    bool isOrderedBefore(const ProductSummary& a, const ProductSummary& b) const;
+    int rowOfProduct(int productId) const;
+    void loadFirstPage(const ProductRepository::PageFilters& filters);
+    void applyProducts(int request, const QList<ProductSummary>& products);
+    QVariantMap summaryToVariantMap(const ProductSummary& product) const;
     QVariantMap productToVariantMap(const Product& product) const;
 };
 
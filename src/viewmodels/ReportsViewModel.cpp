@@ -1,5 +1,9 @@
 #include "ReportsViewModel.h"
 #include "../repositories/SaleRepository.h"
+#include "../database/DatabaseWorker.h"
+#include "../database/ReadSnapshot.h"
+#include "../utils/UiStallMonitor.h"
+#include <QElapsedTimer>
 #include <QDebug>
 
 ReportsViewModel::ReportsViewModel(QObject *parent)
@@ -86,12 +90,47 @@ void ReportsViewModel::loadReport()
     
     qDebug() << "Cargando reporte:" << m_periodType << "desde" << m_startDate << "hasta" << m_endDate;
     
-    calculateSummary();
-    loadSalesHistory();
-    
-    setIsLoading(false);
-    
-    emit reportGenerated("Reporte generado exitosamente");
+    const QDate startDate = m_startDate;
+    const QDate endDate = m_endDate;
+    const int request = ++m_reportRequest;
+
+    QElapsedTimer timer;
+    timer.start();
+    const UiStallMonitor::Stats stallsBefore = UiStallMonitor::instance().stats();
+
+    // Las consultas se ejecutan en el hilo de lectura; el hilo de QML
+    // sólo aplica el resultado. Los bloqueos de UI durante la carga se
+    // registran al terminar. Resumen e historial salen de la misma instantánea.
+    DatabaseWorker::readerInstance().run([startDate, endDate]() {
+        ReadSnapshot snapshot;
+        ReportData data;
+        data.summary = calculateSummary(startDate, endDate);
+        data.salesHistory = loadSalesHistory(startDate, endDate);
+        return data;
+    }).then(this, [this, request, timer, stallsBefore](const ReportData& data) {
+        if (request != m_reportRequest) {
+            return;  // El usuario ya pidió otro período
+        }
+
+        m_summary = data.summary;
+        m_salesHistory = data.salesHistory;
+        emit summaryChanged();
+        emit salesHistoryChanged();
+
+        setIsLoading(false);
+
+        const UiStallMonitor::Stats stalls = UiStallMonitor::instance().stats();
+        qDebug() << "Reporte cargado en" << timer.elapsed() << "ms;"
+                 << "bloqueos de UI:" << (stalls.stalls - stallsBefore.stalls)
+                 << "(" << (stalls.totalNs - stallsBefore.totalNs) / 1000000 << "ms )";
+
+        emit reportGenerated("Reporte generado exitosamente");
+    }).onCanceled(this, [this, request]() {
+        // El hilo de lectura descartó la tarea al cerrar
+        if (request == m_reportRequest) {
+            setIsLoading(false);
+        }
+    });
 }
 
 void ReportsViewModel::exportToPdf(const QString& filePath)
@@ -105,6 +144,7 @@ QVariantList ReportsViewModel::getChartData()
 {
     QVariantList chartData;
     
+    ReadSnapshot snapshot;
     SaleRepository repo;
     auto dailySales = repo.getDailySalesInRange(m_startDate, m_endDate);
     
@@ -127,18 +167,19 @@ void ReportsViewModel::setIsLoading(bool loading)
     }
 }
 
-void ReportsViewModel::calculateSummary()
+QVariantMap ReportsViewModel::calculateSummary(const QDate& startDate, const QDate& endDate)
 {
+    ReadSnapshot snapshot;  // Reutiliza la del llamador si ya hay una abierta
     SaleRepository repo;
-    auto stats = repo.getStatsForDateRange(m_startDate, m_endDate);
+    auto stats = repo.getStatsForDateRange(startDate, endDate);
     
-    m_summary.clear();
-    m_summary["totalSales"] = stats.totalSales;
-    m_summary["totalTransactions"] = stats.totalTransactions;
-    m_summary["averageTicket"] = stats.averageTicket;
+    QVariantMap summary;
+    summary["totalSales"] = stats.totalSales;
+    summary["totalTransactions"] = stats.totalTransactions;
+    summary["averageTicket"] = stats.averageTicket;
     
     // Obtener productos más vendidos
-    auto topProducts = repo.getTopProducts(m_startDate, m_endDate, 5);
+    auto topProducts = repo.getTopProducts(startDate, endDate, 5);
     QVariantList topProductsList;
     for (const auto& product : topProducts) {
         QVariantMap productMap;
@@ -148,13 +189,13 @@ void ReportsViewModel::calculateSummary()
         productMap["totalRevenue"] = product.totalRevenue;
         topProductsList.append(productMap);
     }
-    m_summary["topProducts"] = topProductsList;
+    summary["topProducts"] = topProductsList;
     
     // Calcular comparación con período anterior (opcional)
     QDate previousStart, previousEnd;
-    int days = m_startDate.daysTo(m_endDate) + 1;
-    previousStart = m_startDate.addDays(-days);
-    previousEnd = m_endDate.addDays(-days);
+    int days = startDate.daysTo(endDate) + 1;
+    previousStart = startDate.addDays(-days);
+    previousEnd = endDate.addDays(-days);
     
     auto previousStats = repo.getStatsForDateRange(previousStart, previousEnd);
     
@@ -162,18 +203,19 @@ void ReportsViewModel::calculateSummary()
     if (previousStats.totalSales > 0) {
         salesGrowth = ((stats.totalSales - previousStats.totalSales) / previousStats.totalSales) * 100.0;
     }
-    m_summary["salesGrowth"] = salesGrowth;
-    m_summary["previousSales"] = previousStats.totalSales;
+    summary["salesGrowth"] = salesGrowth;
+    summary["previousSales"] = previousStats.totalSales;
     
-    emit summaryChanged();
+    return summary;
 }
 
-void ReportsViewModel::loadSalesHistory()
+QVariantList ReportsViewModel::loadSalesHistory(const QDate& startDate, const QDate& endDate)
 {
     SaleRepository repo;
-    auto sales = repo.findByDateRange(m_startDate, m_endDate);
+    // El historial solo muestra la cantidad de items
+    auto sales = repo.findByDateRange(startDate, endDate, SaleRepository::ItemLoading::CountsOnly);
     
-    m_salesHistory.clear();
+    QVariantList salesHistory;
     
     for (const auto& sale : sales) {
         QVariantMap saleMap;
@@ -184,10 +226,10 @@ void ReportsViewModel::loadSalesHistory()
         saleMap["paymentMethod"] = sale.paymentMethodName;
         saleMap["status"] = sale.status;
         saleMap["date"] = sale.createdAt.toString("dd/MM/yyyy hh:mm");
-        saleMap["itemCount"] = sale.items.count();
+        saleMap["itemCount"] = sale.itemCount();
         
-        m_salesHistory.append(saleMap);
+        salesHistory.append(saleMap);
     }
     
-    emit salesHistoryChanged();
+    return salesHistory;
 }
@@ -76,10 +76,21 @@ private:
     QVariantMap m_summary;
     QVariantList m_salesHistory;
     bool m_isLoading;
+    int m_reportRequest = 0;  // Descarta resultados de cargas ya reemplazadas
+
+    /**
+     * @brief Datos de un reporte, calculados en el hilo de base de datos
+     */
+    struct ReportData {
+        QVariantMap summary;
+        QVariantList salesHistory;
+    };
 
     void setIsLoading(bool loading);
-    void calculateSummary();
-    void loadSalesHistory();
+
+    // Se ejecutan en DatabaseWorker: no deben tocar miembros del ViewModel
+    static QVariantMap calculateSummary(const QDate& startDate, const QDate& endDate);
+    static QVariantList loadSalesHistory(const QDate& startDate, const QDate& endDate);
 };
 
 #endif // REPORTSVIEWMODEL_H
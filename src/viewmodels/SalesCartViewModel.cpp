@@ -1,4 +1,5 @@
 #include "SalesCartViewModel.h"
+#include "../services/CatalogIndex.h"
 #include <QDebug>
 
 // ============================================================================
@@ -240,6 +241,12 @@ bool SalesCartViewModel::searchAndAddProduct(const QString& code, double quantit
         return false;
     }
 
+    // Índice en memoria: código de barras y luego SKU, sin consultar la base
+    if (auto entry = CatalogIndex::instance().findByCode(code)) {
+        return addProduct(entry->toProduct(), quantity);
+    }
+
+    // Índice aún no cargado o producto inactivo: consultar la base
     // Buscar por código de barras primero
     auto product = m_productService.getProductByBarcode(code);
     
@@ -253,52 +260,62 @@ bool SalesCartViewModel::searchAndAddProduct(const QString& code, double quantit
         return false;
     }
 
-    return addProductById(product->id, quantity);
+    return addProduct(*product, quantity);
 }
 
 bool SalesCartViewModel::addProductById(int productId, double quantity)
 {
+    if (auto entry = CatalogIndex::instance().findById(productId)) {
+        return addProduct(entry->toProduct(), quantity);
+    }
+
     auto product = m_productService.getProduct(productId);
     if (!product.has_value()) {
         emit productNotFound(QString::number(productId));
         return false;
     }
 
+    return addProduct(*product, quantity);
+}
+
+bool SalesCartViewModel::addProduct(const Product& product, double quantity)
+{
     // Validar stock
     QString errorMsg;
-    if (!validateStock(product.value(), quantity, errorMsg)) {
-        emit insufficientStock(product->name, product->currentStock, quantity);
+    if (!validateStock(product, quantity, errorMsg)) {
+        emit insufficientStock(product.name, product.currentStock, quantity);
         return false;
     }
 
     // Verificar si ya está en el carrito para ajustar stock disponible
     double alreadyInCart = 0.0;
     for (const auto& item : m_cart->items()) {
-        if (item.productId == productId) {
+        if (item.productId == product.id) {
             alreadyInCart = item.quantity;
             break;
         }
     }
 
-    double availableStock = product->currentStock - alreadyInCart;
+    double availableStock = product.currentStock - alreadyInCart;
 
     m_cart->addItem(
-        product->id,
-        product->name,
-        product->sku,
-        product->barcode,
+        product.id,
+        product.name,
+        product.sku,
+        product.barcode,
         quantity,
-        product->salePrice,
+        product.salePrice,
         availableStock
     );
 
-    emit productAdded(product->name, quantity);
+    emit productAdded(product.name, quantity);
     return true;
 }
 
 bool SalesCartViewModel::processSale(int customerId, const QString& customerName,
                                      int paymentMethodId, const QString& paymentMethodName,
-                                     double discount, const QString& notes)
+                                     double discount, const QString& notes,
+                                     const QString& invoiceSeries)
 {
     qDebug() << "=== processSale ===";
     
@@ -319,6 +336,7 @@ bool SalesCartViewModel::processSale(int customerId, const QString& customerName
     sale.paymentMethodName = paymentMethodName;
     sale.discount = discount;
     sale.notes = notes;
+    sale.invoiceSeries = invoiceSeries;
     sale.items = m_cart->items();
     sale.calculateTotals();
 
@@ -454,7 +472,7 @@ bool SalesCartViewModel::processSaleWithInvoiceData(
     // Procesar la venta
     qDebug() << "  Calling processSale...";
     bool success = processSale(customerId, customerName, paymentMethodId, 
-                              paymentMethodName, m_discount, notes);
+                              paymentMethodName, m_discount, notes, voucherType);
     
     qDebug() << "  processSale result:" << success;
     
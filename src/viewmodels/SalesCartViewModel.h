@@ -115,10 +115,12 @@ public slots:
 
     /**
      * @brief Procesar la venta actual
+     * @param invoiceSeries "BOLETA" o "FACTURA": serie de la que se toma el número
      */
     bool processSale(int customerId, const QString& customerName,
                      int paymentMethodId, const QString& paymentMethodName,
-                     double discount, const QString& notes);
+                     double discount, const QString& notes,
+                     const QString& invoiceSeries = "BOLETA");
     
     /**
      * @brief Procesar venta con datos de factura completos
@@ -167,6 +169,11 @@ private:
 
     void setIsProcessing(bool processing);
     bool validateStock(const Product& product, double quantity, QString& errorMsg);
+
+    /**
+     * @brief Validar stock y agregar al carrito un producto ya resuelto
+     */
+    bool addProduct(const Product& product, double quantity);
 };
 
 #endif // SALESCARTVIEWMODEL_H